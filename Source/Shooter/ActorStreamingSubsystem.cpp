@@ -0,0 +1,361 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ActorStreamingSubsystem.h"
+#include "Kismet/GameplayStatics.h"
+#include "EngineUtils.h"
+#include "Item.h"
+#include "Enemy.h"
+#include "Explosive.h"
+#include "WorldSnapshotSubsystem.h"
+#include "Shooter.h"
+
+DECLARE_CYCLE_STAT(TEXT("Actor Streaming Tick"), STAT_ActorStreamingTick, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Actors Streamed In"), STAT_ActorsStreamedIn, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Actors Streamed Out"), STAT_ActorsStreamedOut, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Streamed Out Records"), STAT_StreamedOutRecords, STATGROUP_Shooter);
+
+static TAutoConsoleVariable<int32> CVarActorStreaming(
+	TEXT("shooter.ActorStreaming"),
+	1,
+	TEXT("Stream far items, enemies and explosives out to records. 0 streams everything back in."));
+
+static TAutoConsoleVariable<float> CVarStreamingCellSize(
+	TEXT("shooter.StreamingCellSize"),
+	5000.f,
+	TEXT("Width of one streaming cell. Read when a world starts."));
+
+static TAutoConsoleVariable<int32> CVarStreamingRadius(
+	TEXT("shooter.StreamingRadius"),
+	2,
+	TEXT("Cells around the player's cell that are kept live."));
+
+static TAutoConsoleVariable<int32> CVarStreamingActorsPerFrame(
+	TEXT("shooter.StreamingActorsPerFrame"),
+	4,
+	TEXT("Most actors spawned or streamed out per frame."));
+
+static TAutoConsoleVariable<float> CVarStreamingUpdateInterval(
+	TEXT("shooter.StreamingUpdateInterval"),
+	0.5f,
+	TEXT("Seconds between checks for actors to stream in or out."));
+
+namespace
+{
+	int32 GetCellDistance(const FIntPoint& A, const FIntPoint& B)
+	{
+		return FMath::Max(FMath::Abs(A.X - B.X), FMath::Abs(A.Y - B.Y));
+	}
+
+	/** Point Record's class index into To instead of From; returns the class, null if it isn't loaded */
+	UClass* MoveRecordClass(const FWorldSnapshot& From, FActorSnapshot& Record, FWorldSnapshot& To)
+	{
+		UClass* Class = From.ClassPaths.IsValidIndex(Record.ClassIndex) ?
+			FSoftClassPath(From.ClassPaths[Record.ClassIndex]).ResolveClass() :
+			nullptr;
+		if (Class)
+		{
+			Record.ClassIndex = To.AddClass(Class);
+		}
+		return Class;
+	}
+}
+
+void UActorStreamingSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	CellSize = FMath::Max(CVarStreamingCellSize.GetValueOnGameThread(), 100.f);
+}
+
+UActorStreamingSubsystem* UActorStreamingSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+	return World ? World->GetSubsystem<UActorStreamingSubsystem>() : nullptr;
+}
+
+void UActorStreamingSubsystem::CaptureStreamedOut(FWorldSnapshot& Snapshot) const
+{
+	for (const TPair<FIntPoint, FWorldSnapshot>& Cell : Cells)
+	{
+		const FWorldSnapshot& Records = Cell.Value;
+		for (FItemSnapshot Record : Records.Items)
+		{
+			if (MoveRecordClass(Records, Record.Actor, Snapshot))
+			{
+				Snapshot.Items.Add(Record);
+			}
+		}
+		for (FEnemySnapshot Record : Records.Enemies)
+		{
+			if (MoveRecordClass(Records, Record.Actor, Snapshot))
+			{
+				Snapshot.Enemies.Add(Record);
+			}
+		}
+		for (FActorSnapshot Record : Records.Explosives)
+		{
+			if (MoveRecordClass(Records, Record, Snapshot))
+			{
+				Snapshot.Explosives.Add(Record);
+			}
+		}
+	}
+}
+
+void UActorStreamingSubsystem::DiscardStreamedOut()
+{
+	Cells.Empty();
+	PendingStreamIn.Reset();
+	PendingStreamOut.Reset();
+	NumStreamedOut = 0;
+}
+
+bool UActorStreamingSubsystem::AdoptItem(const FWorldSnapshot& Snapshot, const FItemSnapshot& Record, const FVector& ViewerLocation)
+{
+	if (CVarActorStreaming.GetValueOnGameThread() == 0 ||
+		Record.ItemState != static_cast<uint8>(EItemState::EIS_Pickup) ||
+		!IsStreamedOutCell(GetCell(Record.Actor.Location), GetCell(ViewerLocation)))
+	{
+		return false;
+	}
+
+	FItemSnapshot Adopted{ Record };
+	FWorldSnapshot& Records = Cells.FindOrAdd(GetCell(Record.Actor.Location));
+	UClass* Class = MoveRecordClass(Snapshot, Adopted.Actor, Records);
+	if (Class == nullptr) return false;
+
+	StreamedClasses.AddUnique(Class);
+	Records.Items.Add(Adopted);
+	++NumStreamedOut;
+	return true;
+}
+
+bool UActorStreamingSubsystem::AdoptEnemy(const FWorldSnapshot& Snapshot, const FEnemySnapshot& Record, const FVector& ViewerLocation)
+{
+	if (CVarActorStreaming.GetValueOnGameThread() == 0 ||
+		!IsStreamedOutCell(GetCell(Record.Actor.Location), GetCell(ViewerLocation)))
+	{
+		return false;
+	}
+
+	FEnemySnapshot Adopted{ Record };
+	FWorldSnapshot& Records = Cells.FindOrAdd(GetCell(Record.Actor.Location));
+	UClass* Class = MoveRecordClass(Snapshot, Adopted.Actor, Records);
+	if (Class == nullptr) return false;
+
+	StreamedClasses.AddUnique(Class);
+	Records.Enemies.Add(Adopted);
+	++NumStreamedOut;
+	return true;
+}
+
+bool UActorStreamingSubsystem::AdoptExplosive(const FWorldSnapshot& Snapshot, const FActorSnapshot& Record, const FVector& ViewerLocation)
+{
+	if (CVarActorStreaming.GetValueOnGameThread() == 0 ||
+		!IsStreamedOutCell(GetCell(Record.Location), GetCell(ViewerLocation)))
+	{
+		return false;
+	}
+
+	FActorSnapshot Adopted{ Record };
+	FWorldSnapshot& Records = Cells.FindOrAdd(GetCell(Record.Location));
+	UClass* Class = MoveRecordClass(Snapshot, Adopted, Records);
+	if (Class == nullptr) return false;
+
+	StreamedClasses.AddUnique(Class);
+	Records.Explosives.Add(Adopted);
+	++NumStreamedOut;
+	return true;
+}
+
+void UActorStreamingSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ActorStreamingTick);
+
+	const APawn* Player = UGameplayStatics::GetPlayerPawn(this, 0);
+	if (Player == nullptr) return;
+
+	TimeSinceUpdate += DeltaTime;
+	if (TimeSinceUpdate >= CVarStreamingUpdateInterval.GetValueOnGameThread())
+	{
+		TimeSinceUpdate = 0.f;
+		UpdateQueues(GetCell(Player->GetActorLocation()));
+	}
+
+	// Stream in first, nearest cell first: the player is heading towards those
+	int32 Budget{ CVarStreamingActorsPerFrame.GetValueOnGameThread() };
+	while (Budget > 0 && PendingStreamIn.Num() > 0)
+	{
+		FWorldSnapshot* Records = Cells.Find(PendingStreamIn.Last());
+		if (Records && StreamInOne(*Records))
+		{
+			--Budget;
+			continue;
+		}
+		Cells.Remove(PendingStreamIn.Last());
+		PendingStreamIn.Pop(false);
+	}
+
+	while (Budget > 0 && PendingStreamOut.Num() > 0)
+	{
+		if (StreamOut(PendingStreamOut.Pop(false).Get()))
+		{
+			--Budget;
+		}
+	}
+
+	SET_DWORD_STAT(STAT_StreamedOutRecords, NumStreamedOut);
+}
+
+bool UActorStreamingSubsystem::IsTickable() const
+{
+	if (IsTemplate()) return false;
+
+	const UWorld* World = GetWorld();
+	return World && World->IsGameWorld() && World->HasBegunPlay();
+}
+
+TStatId UActorStreamingSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UActorStreamingSubsystem, STATGROUP_Tickables);
+}
+
+FIntPoint UActorStreamingSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntPoint(
+		FMath::FloorToInt(Location.X / CellSize),
+		FMath::FloorToInt(Location.Y / CellSize));
+}
+
+bool UActorStreamingSubsystem::IsLiveCell(const FIntPoint& Cell, const FIntPoint& FromCell)
+{
+	return GetCellDistance(Cell, FromCell) <= CVarStreamingRadius.GetValueOnGameThread();
+}
+
+bool UActorStreamingSubsystem::IsStreamedOutCell(const FIntPoint& Cell, const FIntPoint& FromCell)
+{
+	return GetCellDistance(Cell, FromCell) > CVarStreamingRadius.GetValueOnGameThread() + 1;
+}
+
+void UActorStreamingSubsystem::UpdateQueues(const FIntPoint& NewViewerCell)
+{
+	ViewerCell = NewViewerCell;
+	const bool bStreamingEnabled{ CVarActorStreaming.GetValueOnGameThread() != 0 };
+
+	// Sorted so the nearest cell is at the end, where it is taken from
+	PendingStreamIn.Reset();
+	for (const TPair<FIntPoint, FWorldSnapshot>& Cell : Cells)
+	{
+		if (!bStreamingEnabled || IsLiveCell(Cell.Key, ViewerCell))
+		{
+			PendingStreamIn.Add(Cell.Key);
+		}
+	}
+	PendingStreamIn.Sort([this](const FIntPoint& A, const FIntPoint& B)
+		{
+			return GetCellDistance(A, ViewerCell) > GetCellDistance(B, ViewerCell);
+		});
+
+	// Actors are checked again when their turn comes; they may have moved or been picked up by then
+	PendingStreamOut.Reset();
+	if (!bStreamingEnabled) return;
+
+	auto QueueFarActors = [this](AActor* Actor)
+	{
+		if (CanStreamOut(Actor) && IsStreamedOutCell(GetCell(Actor->GetActorLocation()), ViewerCell))
+		{
+			PendingStreamOut.Add(Actor);
+		}
+	};
+	for (TActorIterator<AItem> It(GetWorld()); It; ++It)
+	{
+		QueueFarActors(*It);
+	}
+	for (TActorIterator<AEnemy> It(GetWorld()); It; ++It)
+	{
+		QueueFarActors(*It);
+	}
+	for (TActorIterator<AExplosive> It(GetWorld()); It; ++It)
+	{
+		QueueFarActors(*It);
+	}
+}
+
+bool UActorStreamingSubsystem::StreamInOne(FWorldSnapshot& Records)
+{
+	UWorld* World = GetWorld();
+	if (Records.Items.Num() > 0)
+	{
+		const FItemSnapshot Record{ Records.Items.Pop(false) };
+		UWorldSnapshotSubsystem::SpawnItem(World, Records, Record);
+	}
+	else if (Records.Enemies.Num() > 0)
+	{
+		// The only target an enemy can have is the player
+		const FEnemySnapshot Record{ Records.Enemies.Pop(false) };
+		APawn* Player = UGameplayStatics::GetPlayerPawn(this, 0);
+		AActor* Target = Player && Player->GetFName() == Record.Target ? Player : nullptr;
+		UWorldSnapshotSubsystem::SpawnEnemy(World, Records, Record, Target);
+	}
+	else if (Records.Explosives.Num() > 0)
+	{
+		const FActorSnapshot Record{ Records.Explosives.Pop(false) };
+		UWorldSnapshotSubsystem::SpawnExplosive(World, Records, Record);
+	}
+	else
+	{
+		return false;
+	}
+
+	--NumStreamedOut;
+	INC_DWORD_STAT(STAT_ActorsStreamedIn);
+	return true;
+}
+
+bool UActorStreamingSubsystem::StreamOut(AActor* Actor)
+{
+	if (Actor == nullptr || !CanStreamOut(Actor)) return false;
+
+	const FVector Location{ Actor->GetActorLocation() };
+	if (!IsStreamedOutCell(GetCell(Location), ViewerCell)) return false;
+
+	// Keep the class loaded so the record can be spawned again
+	StreamedClasses.AddUnique(Actor->GetClass());
+	FWorldSnapshot& Records = Cells.FindOrAdd(GetCell(Location));
+	if (const AItem* Item = Cast<AItem>(Actor))
+	{
+		FItemSnapshot& Record = Records.Items.AddDefaulted_GetRef();
+		UWorldSnapshotSubsystem::CaptureActor(Records, Item, Record.Actor);
+		Item->CaptureSnapshot(Record);
+	}
+	else if (const AEnemy* Enemy = Cast<AEnemy>(Actor))
+	{
+		FEnemySnapshot& Record = Records.Enemies.AddDefaulted_GetRef();
+		UWorldSnapshotSubsystem::CaptureActor(Records, Enemy, Record.Actor);
+		Enemy->CaptureSnapshot(Record);
+	}
+	else
+	{
+		UWorldSnapshotSubsystem::CaptureActor(Records, Actor, Records.Explosives.AddDefaulted_GetRef());
+	}
+
+	Actor->Destroy();
+	++NumStreamedOut;
+	INC_DWORD_STAT(STAT_ActorsStreamedOut);
+	return true;
+}
+
+bool UActorStreamingSubsystem::CanStreamOut(const AActor* Actor)
+{
+	// Items anywhere but on the ground belong to the player, or are about to
+	if (const AItem* Item = Cast<AItem>(Actor))
+	{
+		return Item->GetItemState() == EItemState::EIS_Pickup;
+	}
+	if (const AEnemy* Enemy = Cast<AEnemy>(Actor))
+	{
+		return !Enemy->GetDying();
+	}
+	return Actor->IsA<AExplosive>();
+}
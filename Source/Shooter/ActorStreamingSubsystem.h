@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "WorldSnapshot.h"
+#include "ActorStreamingSubsystem.generated.h"
+
+/**
+ * Streams items, enemies and explosives by grid cell around the player. Actors in far
+ * cells are turned into the same records world snapshots use and destroyed; the records
+ * are spawned back as actors when the player comes near again. Both directions run under
+ * a per-frame actor budget, so live actors scale with the player's surroundings rather
+ * than with the map. Only actors that can be rebuilt from a record are streamed: items
+ * lying as pickups, enemies that aren't dying, and explosives.
+ */
+UCLASS()
+class SHOOTER_API UActorStreamingSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	static UActorStreamingSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Add the streamed out records to Snapshot, so it covers the whole level */
+	void CaptureStreamedOut(FWorldSnapshot& Snapshot) const;
+
+	/** Forget every streamed out record; the actors they stood for are gone */
+	void DiscardStreamedOut();
+
+	/**
+	* Keep Record as a record if it is in a cell streamed out from ViewerLocation
+	* @return True if adopted, so the caller shouldn't spawn it
+	*/
+	bool AdoptItem(const FWorldSnapshot& Snapshot, const FItemSnapshot& Record, const FVector& ViewerLocation);
+	bool AdoptEnemy(const FWorldSnapshot& Snapshot, const FEnemySnapshot& Record, const FVector& ViewerLocation);
+	bool AdoptExplosive(const FWorldSnapshot& Snapshot, const FActorSnapshot& Record, const FVector& ViewerLocation);
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+private:
+	FIntPoint GetCell(const FVector& Location) const;
+
+	/** Records in cells this close to the player are spawned */
+	static bool IsLiveCell(const FIntPoint& Cell, const FIntPoint& FromCell);
+
+	/** Actors in cells this far from the player are streamed out; one cell further than live, against thrashing */
+	static bool IsStreamedOutCell(const FIntPoint& Cell, const FIntPoint& FromCell);
+
+	/** Find far cells with live actors and near cells with records */
+	void UpdateQueues(const FIntPoint& ViewerCell);
+
+	/** Spawn one record from Records; false once it is empty */
+	bool StreamInOne(FWorldSnapshot& Records);
+
+	/** Turn Actor into a record if it is still streamable and far */
+	bool StreamOut(AActor* Actor);
+
+	static bool CanStreamOut(const AActor* Actor);
+
+	/** Records of the streamed out actors, by cell; each cell has its own class table */
+	TMap<FIntPoint, FWorldSnapshot> Cells;
+
+	/** Classes with streamed out records, kept loaded so they can be spawned again */
+	UPROPERTY()
+	TArray<UClass*> StreamedClasses;
+
+	TArray<FIntPoint> PendingStreamIn;
+	TArray<TWeakObjectPtr<AActor>> PendingStreamOut;
+
+	/** Read from shooter.StreamingCellSize when the world starts, so cells stay consistent */
+	float CellSize{ 5000.f };
+
+	FIntPoint ViewerCell{ FIntPoint::ZeroValue };
+	float TimeSinceUpdate{ 0.f };
+	int32 NumStreamedOut{ 0 };
+};
@@ -6,8 +6,12 @@
 #include "Components/WidgetComponent.h"
 #include "Components/SphereComponent.h"
 #include "ShooterCharacter.h"
+#include "Engine/CollisionProfile.h"
+#include "AmmoTypeSubsystem.h"
+#include "Shooter.h"
 
-AAmmo::AAmmo()
+AAmmo::AAmmo() :
+	AmmoTypeId(-1)
 {
 	// Construct the AmmoMesh component and set it as the root
 	AmmoMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("AmmoMesh"));
@@ -20,6 +24,7 @@ AAmmo::AAmmo()
 	AmmoCollisionSphere = CreateDefaultSubobject<USphereComponent>(TEXT("AmmoCollisionSphere"));
 	AmmoCollisionSphere->SetupAttachment(GetRootComponent());
 	AmmoCollisionSphere->SetSphereRadius(50.f);
+	AmmoCollisionSphere->SetCollisionResponseToChannel(ECC_Weapon, ECollisionResponse::ECR_Ignore);
 }
 
 void AAmmo::Tick(float DeltaTime)
@@ -32,48 +37,27 @@ void AAmmo::BeginPlay()
 {
 	Super::BeginPlay();
 
+	if (UAmmoTypeSubsystem* AmmoTypes = UAmmoTypeSubsystem::Get(this))
+	{
+		AmmoTypeId = AmmoTypes->ResolveAmmoTypeId(AmmoTypeName, AmmoType);
+	}
+
 	AmmoCollisionSphere->OnComponentBeginOverlap.AddDynamic(this, &AAmmo::AmmoSphereOverlap);
 }
 
 void AAmmo::SetItemProperties(EItemState State)
 {
 	Super::SetItemProperties(State);
-	switch (State)
+
+	// Set mesh properties
+	const bool bFalling{ State == EItemState::EIS_Falling };
+	SetCollisionProfile(
+		AmmoMesh,
+		bFalling ? FName(TEXT("AmmoFallingMesh")) : UCollisionProfile::NoCollision_ProfileName);
+	SetPhysicsState(AmmoMesh, bFalling);
+	if (State == EItemState::EIS_Pickup || State == EItemState::EIS_Equipped || State == EItemState::EIS_EquipInterping)
 	{
-	case EItemState::EIS_Pickup:
-		// Set mesh properties
-		AmmoMesh->SetSimulatePhysics(false);
-		AmmoMesh->SetEnableGravity(false);
-		AmmoMesh->SetVisibility(true);
-		AmmoMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		AmmoMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		break;
-	case EItemState::EIS_Equipped:
-		// Set mesh properties
-		AmmoMesh->SetSimulatePhysics(false);
-		AmmoMesh->SetEnableGravity(false);
-		AmmoMesh->SetVisibility(true);
-		AmmoMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		AmmoMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		break;
-	case EItemState::EIS_Falling:
-		// Set mesh properties
-		AmmoMesh->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
-		AmmoMesh->SetSimulatePhysics(true);
-		AmmoMesh->SetEnableGravity(true);
-		AmmoMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		AmmoMesh->SetCollisionResponseToChannel(
-			ECollisionChannel::ECC_WorldStatic,
-			ECollisionResponse::ECR_Block);
-		break;
-	case EItemState::EIS_EquipInterping:
-		// Set mesh properties
-		AmmoMesh->SetSimulatePhysics(false);
-		AmmoMesh->SetEnableGravity(false);
 		AmmoMesh->SetVisibility(true);
-		AmmoMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		AmmoMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		break;
 	}
 }
 
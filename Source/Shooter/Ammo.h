@@ -44,6 +44,13 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Ammo, meta = (AllowPrivateAccess = "true"))
 	EAmmoType AmmoType;
 
+	/** Row in the ammo type table; overrides AmmoType when set */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Ammo, meta = (AllowPrivateAccess = "true"))
+	FName AmmoTypeName;
+
+	/** Registered id for our ammo type, resolved in BeginPlay */
+	int32 AmmoTypeId;
+
 	/** The texture for the Ammo icon */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Ammo, meta = (AllowPrivateAccess = "true"))
 	UTexture2D* AmmoIconTexture;
@@ -55,6 +62,7 @@ private:
 public:
 	FORCEINLINE UStaticMeshComponent* GetAmmoMesh() const { return AmmoMesh; }
 	FORCEINLINE EAmmoType GetAmmoType() const { return AmmoType; }
+	FORCEINLINE int32 GetAmmoTypeId() const { return AmmoTypeId; }
 
 	virtual void EnableCustomDepth() override;
 	virtual void DisableCustomDepth() override;
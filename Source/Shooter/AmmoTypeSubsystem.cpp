@@ -0,0 +1,95 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AmmoTypeSubsystem.h"
+#include "Kismet/GameplayStatics.h"
+
+void UAmmoTypeSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	for (int32& Id : LegacyToId)
+	{
+		Id = -1;
+	}
+
+	// Path to the Ammo Type Data Table
+	const FString AmmoTypeTablePath{ TEXT("DataTable'/Game/_Game/DataTable/AmmoTypeDataTable.AmmoTypeDataTable'") };
+	UDataTable* AmmoTypeTableObject = Cast<UDataTable>(StaticLoadObject(UDataTable::StaticClass(), nullptr, *AmmoTypeTablePath));
+	if (AmmoTypeTableObject)
+	{
+		AmmoTypeTableObject->ForeachRow<FAmmoTypeTable>(TEXT("UAmmoTypeSubsystem::Initialize"),
+			[this](const FName& Key, const FAmmoTypeTable& Row)
+			{
+				RegisterAmmoType(Key, Row);
+			});
+	}
+
+	// Weapons and pickups using the original ammo types still need ids; with no row they start empty
+	if (LegacyToId[static_cast<int32>(EAmmoType::EAT_9mm)] == -1)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Ammo type table has no 9mm row; 9mm ammo starts at 0"));
+		FAmmoTypeTable Row;
+		Row.LegacyType = EAmmoType::EAT_9mm;
+		RegisterAmmoType(FName("9mm"), Row);
+	}
+	if (LegacyToId[static_cast<int32>(EAmmoType::EAT_AR)] == -1)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Ammo type table has no AssaultRifle row; AR ammo starts at 0"));
+		FAmmoTypeTable Row;
+		Row.LegacyType = EAmmoType::EAT_AR;
+		RegisterAmmoType(FName("AssaultRifle"), Row);
+	}
+}
+
+UAmmoTypeSubsystem* UAmmoTypeSubsystem::Get(const UObject* WorldContextObject)
+{
+	UGameInstance* GameInstance = UGameplayStatics::GetGameInstance(WorldContextObject);
+	return GameInstance ? GameInstance->GetSubsystem<UAmmoTypeSubsystem>() : nullptr;
+}
+
+void UAmmoTypeSubsystem::RegisterAmmoType(FName Name, const FAmmoTypeTable& Row)
+{
+	if (NameToId.Contains(Name)) return;
+
+	const int32 Id{ AmmoTypes.Add(Row) };
+	AmmoTypeNames.Add(Name);
+	NameToId.Add(Name, Id);
+
+	if (Row.LegacyType != EAmmoType::EAT_NAX &&
+		LegacyToId[static_cast<int32>(Row.LegacyType)] == -1)
+	{
+		LegacyToId[static_cast<int32>(Row.LegacyType)] = Id;
+	}
+}
+
+int32 UAmmoTypeSubsystem::ResolveAmmoTypeId(FName Name, EAmmoType LegacyType) const
+{
+	const int32 Id{ FindAmmoTypeId(Name) };
+	return Id != -1 ? Id : GetLegacyAmmoTypeId(LegacyType);
+}
+
+int32 UAmmoTypeSubsystem::FindAmmoTypeId(FName Name) const
+{
+	if (Name.IsNone()) return -1;
+
+	const int32* Id = NameToId.Find(Name);
+	return Id ? *Id : -1;
+}
+
+int32 UAmmoTypeSubsystem::GetLegacyAmmoTypeId(EAmmoType LegacyType) const
+{
+	if (LegacyType == EAmmoType::EAT_NAX) return -1;
+
+	return LegacyToId[static_cast<int32>(LegacyType)];
+}
+
+const FAmmoTypeTable* UAmmoTypeSubsystem::GetAmmoType(int32 Id) const
+{
+	return AmmoTypes.IsValidIndex(Id) ? &AmmoTypes[Id] : nullptr;
+}
+
+FName UAmmoTypeSubsystem::GetAmmoTypeName(int32 Id) const
+{
+	return AmmoTypeNames.IsValidIndex(Id) ? AmmoTypeNames[Id] : NAME_None;
+}
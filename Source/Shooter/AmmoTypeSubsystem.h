@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Engine/DataTable.h"
+#include "AmmoType.h"
+#include "AmmoTypeSubsystem.generated.h"
+
+/** One row per ammo type; the row name is the ammo type's name */
+USTRUCT(BlueprintType)
+struct FAmmoTypeTable : public FTableRowBase
+{
+	GENERATED_BODY()
+
+	/** EAmmoType this row stands in for; DefaultMAX for types added in data only */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	EAmmoType LegacyType = EAmmoType::EAT_NAX;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	UTexture2D* AmmoIcon = nullptr;
+
+	/** Amount the Character starts with */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 StartingAmmo = 0;
+
+	/** Most the Character can carry; 0 for no limit */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 MaxCarriedAmmo = 0;
+};
+
+/**
+ * Registers the ammo types from the ammo type data table at startup and
+ * hands out dense ids (the row order) so carried ammo can live in a flat array.
+ * Starting ammo and carry limits come only from the table.
+ */
+UCLASS()
+class SHOOTER_API UAmmoTypeSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	static UAmmoTypeSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Id for Name, falling back to LegacyType when Name is None or unknown. -1 if neither is registered */
+	int32 ResolveAmmoTypeId(FName Name, EAmmoType LegacyType) const;
+
+	UFUNCTION(BlueprintPure, Category = Ammo)
+	int32 FindAmmoTypeId(FName Name) const;
+
+	UFUNCTION(BlueprintPure, Category = Ammo)
+	int32 GetLegacyAmmoTypeId(EAmmoType LegacyType) const;
+
+	/** Null for an invalid id */
+	const FAmmoTypeTable* GetAmmoType(int32 Id) const;
+
+	UFUNCTION(BlueprintPure, Category = Ammo)
+	FName GetAmmoTypeName(int32 Id) const;
+
+	UFUNCTION(BlueprintPure, Category = Ammo)
+	int32 GetNumAmmoTypes() const { return AmmoTypes.Num(); }
+
+private:
+	void RegisterAmmoType(FName Name, const FAmmoTypeTable& Row);
+
+	/** Registered ammo types, indexed by id */
+	UPROPERTY()
+	TArray<FAmmoTypeTable> AmmoTypes;
+
+	/** Row names, indexed by id */
+	TArray<FName> AmmoTypeNames;
+
+	TMap<FName, int32> NameToId;
+
+	/** Id for each EAmmoType, -1 if the table has no row for it */
+	int32 LegacyToId[static_cast<int32>(EAmmoType::EAT_NAX)];
+};
@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BTDecorator_EnemyState.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "AIController.h"
+#include "Enemy.h"
+
+UBTDecorator_EnemyState::UBTDecorator_EnemyState() :
+	bRequireAlive(true),
+	bRequireNotStunned(true),
+	bRequireCanAttack(false),
+	bRequireInAttackRange(false)
+{
+	NodeName = TEXT("Enemy State");
+	bNotifyBecomeRelevant = true;
+	bNotifyTick = true;
+}
+
+bool UBTDecorator_EnemyState::CalculateRawConditionValue(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) const
+{
+	const AAIController* Controller = OwnerComp.GetAIOwner();
+	const AEnemy* Enemy = Controller ? Cast<AEnemy>(Controller->GetPawn()) : nullptr;
+	if (Enemy == nullptr) return false;
+
+	if (bRequireAlive && Enemy->GetDying()) return false;
+	if (bRequireNotStunned && Enemy->GetStunned()) return false;
+	if (bRequireCanAttack && !Enemy->GetCanAttack()) return false;
+	if (bRequireInAttackRange && !Enemy->GetInAttackRange()) return false;
+
+	return true;
+}
+
+uint16 UBTDecorator_EnemyState::GetInstanceMemorySize() const
+{
+	return sizeof(FEnemyStateMemory);
+}
+
+void UBTDecorator_EnemyState::OnBecomeRelevant(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	FEnemyStateMemory* Memory = reinterpret_cast<FEnemyStateMemory*>(NodeMemory);
+	Memory->bLastResult = CalculateRawConditionValue(OwnerComp, NodeMemory);
+}
+
+void UBTDecorator_EnemyState::TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
+{
+	FEnemyStateMemory* Memory = reinterpret_cast<FEnemyStateMemory*>(NodeMemory);
+	const bool bResult{ CalculateRawConditionValue(OwnerComp, NodeMemory) };
+	if (bResult != Memory->bLastResult)
+	{
+		Memory->bLastResult = bResult;
+
+		// Let the tree re-evaluate this branch; FlowAbortMode decides what gets aborted
+		OwnerComp.RequestExecution(this);
+	}
+}
+
+FString UBTDecorator_EnemyState::GetStaticDescription() const
+{
+	TArray<FString> Conditions;
+	if (bRequireAlive) Conditions.Add(TEXT("alive"));
+	if (bRequireNotStunned) Conditions.Add(TEXT("not stunned"));
+	if (bRequireCanAttack) Conditions.Add(TEXT("can attack"));
+	if (bRequireInAttackRange) Conditions.Add(TEXT("in attack range"));
+
+	return FString::Printf(TEXT("%s: %s"),
+		*Super::GetStaticDescription(),
+		Conditions.Num() > 0 ? *FString::Join(Conditions, TEXT(", ")) : TEXT("always"));
+}
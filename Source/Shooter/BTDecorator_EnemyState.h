@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BTDecorator.h"
+#include "BTDecorator_EnemyState.generated.h"
+
+/**
+ * Gates a branch on the enemy's own state flags instead of one Blackboard decorator per flag.
+ * Re-checks every tick while relevant and aborts per FlowAbortMode when the result flips;
+ * the last result is the only thing kept in node memory.
+ */
+UCLASS()
+class SHOOTER_API UBTDecorator_EnemyState : public UBTDecorator
+{
+	GENERATED_BODY()
+
+public:
+	UBTDecorator_EnemyState();
+
+	virtual bool CalculateRawConditionValue(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) const override;
+	virtual uint16 GetInstanceMemorySize() const override;
+	virtual FString GetStaticDescription() const override;
+
+protected:
+	virtual void OnBecomeRelevant(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual void TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds) override;
+
+private:
+	struct FEnemyStateMemory
+	{
+		bool bLastResult;
+	};
+
+	/** Fails once the enemy starts dying */
+	UPROPERTY(EditAnywhere, Category = Condition)
+	bool bRequireAlive;
+
+	UPROPERTY(EditAnywhere, Category = Condition)
+	bool bRequireNotStunned;
+
+	/** Attack cooldown has run out */
+	UPROPERTY(EditAnywhere, Category = Condition)
+	bool bRequireCanAttack;
+
+	UPROPERTY(EditAnywhere, Category = Condition)
+	bool bRequireInAttackRange;
+};
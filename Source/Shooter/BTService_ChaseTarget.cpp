@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BTService_ChaseTarget.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "AIController.h"
+
+UBTService_ChaseTarget::UBTService_ChaseTarget() :
+	LoseTargetDistance(0.f)
+{
+	NodeName = TEXT("Chase Target");
+	Interval = 0.5f;
+	RandomDeviation = 0.1f;
+
+	TargetKey.SelectedKeyName = FName("Target");
+	TargetKey.AddObjectFilter(this, GET_MEMBER_NAME_CHECKED(UBTService_ChaseTarget, TargetKey), AActor::StaticClass());
+}
+
+void UBTService_ChaseTarget::InitializeFromAsset(UBehaviorTree& Asset)
+{
+	Super::InitializeFromAsset(Asset);
+
+	UBlackboardData* BlackboardAsset = GetBlackboardAsset();
+	if (BlackboardAsset)
+	{
+		TargetKey.ResolveSelectedKey(*BlackboardAsset);
+	}
+}
+
+void UBTService_ChaseTarget::TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
+{
+	Super::TickNode(OwnerComp, NodeMemory, DeltaSeconds);
+
+	UBlackboardComponent* Blackboard = OwnerComp.GetBlackboardComponent();
+	const AAIController* Controller = OwnerComp.GetAIOwner();
+	const APawn* Pawn = Controller ? Controller->GetPawn() : nullptr;
+	if (Blackboard == nullptr || Pawn == nullptr) return;
+
+	UObject* TargetObject = Blackboard->GetValue<UBlackboardKeyType_Object>(TargetKey.GetSelectedKeyID());
+	if (TargetObject == nullptr) return;
+
+	const AActor* Target = Cast<AActor>(TargetObject);
+	const bool bTargetGone{ Target == nullptr || Target->IsPendingKillPending() };
+	const bool bTooFar{ !bTargetGone && LoseTargetDistance > 0.f &&
+		FVector::DistSquared(Pawn->GetActorLocation(), Target->GetActorLocation()) > FMath::Square(LoseTargetDistance) };
+	if (bTargetGone || bTooFar)
+	{
+		Blackboard->ClearValue(TargetKey.GetSelectedKeyID());
+	}
+}
+
+FString UBTService_ChaseTarget::GetStaticDescription() const
+{
+	return FString::Printf(TEXT("%s\nClear %s when gone%s"),
+		*Super::GetStaticDescription(),
+		*TargetKey.SelectedKeyName.ToString(),
+		LoseTargetDistance > 0.f ? *FString::Printf(TEXT(" or beyond %.0f"), LoseTargetDistance) : TEXT(""));
+}
@@ -0,0 +1,35 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BTService.h"
+#include "BTService_ChaseTarget.generated.h"
+
+/**
+ * Runs under the chase branch (a MoveTo on Target) and clears Target once it is
+ * gone or has got too far away, so the tree drops back to patrolling.
+ * Stateless, so it runs without instance memory.
+ */
+UCLASS()
+class SHOOTER_API UBTService_ChaseTarget : public UBTService
+{
+	GENERATED_BODY()
+
+public:
+	UBTService_ChaseTarget();
+
+	virtual void InitializeFromAsset(UBehaviorTree& Asset) override;
+	virtual FString GetStaticDescription() const override;
+
+protected:
+	virtual void TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds) override;
+
+private:
+	UPROPERTY(EditAnywhere, Category = Blackboard)
+	FBlackboardKeySelector TargetKey;
+
+	/** Give up the chase beyond this distance; 0 to never give up */
+	UPROPERTY(EditAnywhere, Category = Chase)
+	float LoseTargetDistance;
+};
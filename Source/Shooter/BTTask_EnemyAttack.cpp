@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BTTask_EnemyAttack.h"
+#include "AIController.h"
+#include "Enemy.h"
+
+UBTTask_EnemyAttack::UBTTask_EnemyAttack() :
+	PlayRate(1.f)
+{
+	NodeName = TEXT("Enemy Attack");
+	bNotifyTick = true;
+}
+
+EBTNodeResult::Type UBTTask_EnemyAttack::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	const AAIController* Controller = OwnerComp.GetAIOwner();
+	AEnemy* Enemy = Controller ? Cast<AEnemy>(Controller->GetPawn()) : nullptr;
+	if (Enemy == nullptr || Enemy->GetDying() || Enemy->GetStunned()) return EBTNodeResult::Failed;
+
+	Enemy->PlayAttackMontage(Enemy->GetAttackSectionName(), PlayRate);
+
+	// No montage to wait on
+	if (!Enemy->IsPlayingAttackMontage()) return EBTNodeResult::Succeeded;
+
+	return EBTNodeResult::InProgress;
+}
+
+void UBTTask_EnemyAttack::TickTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
+{
+	const AAIController* Controller = OwnerComp.GetAIOwner();
+	const AEnemy* Enemy = Controller ? Cast<AEnemy>(Controller->GetPawn()) : nullptr;
+	if (Enemy == nullptr || Enemy->GetDying())
+	{
+		FinishLatentTask(OwnerComp, EBTNodeResult::Failed);
+	}
+	else if (!Enemy->IsPlayingAttackMontage())
+	{
+		// Ended, or a hit react or stun cut it short
+		FinishLatentTask(OwnerComp, EBTNodeResult::Succeeded);
+	}
+}
+
+FString UBTTask_EnemyAttack::GetStaticDescription() const
+{
+	return FString::Printf(TEXT("Random attack section at play rate %.2f"), PlayRate);
+}
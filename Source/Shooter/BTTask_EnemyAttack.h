@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BTTaskNode.h"
+#include "BTTask_EnemyAttack.generated.h"
+
+/**
+ * Plays a random attack section on the enemy and finishes when the attack montage ends.
+ * Holds no state of its own; the enemy's montage is the only thing it waits on.
+ */
+UCLASS()
+class SHOOTER_API UBTTask_EnemyAttack : public UBTTaskNode
+{
+	GENERATED_BODY()
+
+public:
+	UBTTask_EnemyAttack();
+
+	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual void TickTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds) override;
+	virtual FString GetStaticDescription() const override;
+
+private:
+	UPROPERTY(EditAnywhere, Category = Attack)
+	float PlayRate;
+};
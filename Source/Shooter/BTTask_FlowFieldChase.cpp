@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BTTask_FlowFieldChase.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "AIController.h"
+#include "Enemy.h"
+#include "FlowFieldSubsystem.h"
+
+UBTTask_FlowFieldChase::UBTTask_FlowFieldChase() :
+	AcceptanceRadius(100.f)
+{
+	NodeName = TEXT("Flow Field Chase");
+	bNotifyTick = true;
+
+	TargetKey.SelectedKeyName = FName("Target");
+	TargetKey.AddObjectFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_FlowFieldChase, TargetKey), AActor::StaticClass());
+}
+
+EBTNodeResult::Type UBTTask_FlowFieldChase::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	return StepChase(OwnerComp);
+}
+
+void UBTTask_FlowFieldChase::TickTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
+{
+	const EBTNodeResult::Type Result{ StepChase(OwnerComp) };
+	if (Result != EBTNodeResult::InProgress)
+	{
+		FinishLatentTask(OwnerComp, Result);
+	}
+}
+
+EBTNodeResult::Type UBTTask_FlowFieldChase::StepChase(UBehaviorTreeComponent& OwnerComp) const
+{
+	const UBlackboardComponent* Blackboard = OwnerComp.GetBlackboardComponent();
+	const AAIController* Controller = OwnerComp.GetAIOwner();
+	AEnemy* Enemy = Controller ? Cast<AEnemy>(Controller->GetPawn()) : nullptr;
+	AActor* Target = Blackboard ?
+		Cast<AActor>(Blackboard->GetValue<UBlackboardKeyType_Object>(TargetKey.GetSelectedKeyID())) :
+		nullptr;
+	if (Enemy == nullptr || Target == nullptr || Enemy->GetDying() || Enemy->GetStunned()) return EBTNodeResult::Failed;
+
+	const FVector Location{ Enemy->GetActorLocation() };
+	if (Enemy->GetInAttackRange() ||
+		FVector::DistSquared2D(Location, Target->GetActorLocation()) <= FMath::Square(AcceptanceRadius))
+	{
+		return EBTNodeResult::Succeeded;
+	}
+
+	UFlowFieldSubsystem* FlowFields = UFlowFieldSubsystem::Get(Enemy);
+	if (FlowFields == nullptr) return EBTNodeResult::Failed;
+
+	FVector Direction;
+	switch (FlowFields->SampleDirection(Target, Location, Direction))
+	{
+	case EFlowFieldSample::Direction:
+		Enemy->AddMovementInput(Direction);
+		return EBTNodeResult::InProgress;
+	case EFlowFieldSample::Building:
+		// Wait a few frames for it; failing here would hand the whole chase to the fallback MoveTo
+		return EBTNodeResult::InProgress;
+	default:
+		return EBTNodeResult::Failed;
+	}
+}
+
+void UBTTask_FlowFieldChase::InitializeFromAsset(UBehaviorTree& Asset)
+{
+	Super::InitializeFromAsset(Asset);
+
+	UBlackboardData* BlackboardAsset = GetBlackboardAsset();
+	if (BlackboardAsset)
+	{
+		TargetKey.ResolveSelectedKey(*BlackboardAsset);
+	}
+}
+
+FString UBTTask_FlowFieldChase::GetStaticDescription() const
+{
+	return FString::Printf(TEXT("Follow the flow field to %s, within %.0f"),
+		*TargetKey.SelectedKeyName.ToString(),
+		AcceptanceRadius);
+}
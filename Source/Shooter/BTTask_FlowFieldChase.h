@@ -0,0 +1,38 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BTTaskNode.h"
+#include "BTTask_FlowFieldChase.generated.h"
+
+/**
+ * Chases Target by walking down the shared flow field instead of running a path query.
+ * Waits while the target's first field is built. Fails when the enemy is off the field or
+ * cut off from the target, so a MoveTo placed after it under a Selector covers those cases
+ * with a normal path.
+ */
+UCLASS()
+class SHOOTER_API UBTTask_FlowFieldChase : public UBTTaskNode
+{
+	GENERATED_BODY()
+
+public:
+	UBTTask_FlowFieldChase();
+
+	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual void TickTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds) override;
+	virtual void InitializeFromAsset(UBehaviorTree& Asset) override;
+	virtual FString GetStaticDescription() const override;
+
+private:
+	/** Walk one step down the field; the result to finish with, or InProgress to keep going */
+	EBTNodeResult::Type StepChase(UBehaviorTreeComponent& OwnerComp) const;
+
+	UPROPERTY(EditAnywhere, Category = Blackboard)
+	FBlackboardKeySelector TargetKey;
+
+	/** Succeed within this distance of Target, or once the enemy is in attack range */
+	UPROPERTY(EditAnywhere, Category = Chase)
+	float AcceptanceRadius;
+};
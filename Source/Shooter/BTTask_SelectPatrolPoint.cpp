@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BTTask_SelectPatrolPoint.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+
+UBTTask_SelectPatrolPoint::UBTTask_SelectPatrolPoint()
+{
+	NodeName = TEXT("Select Patrol Point");
+
+	PatrolPointKey.SelectedKeyName = FName("PatrolPoint");
+	PatrolPoint2Key.SelectedKeyName = FName("PatrolPoint2");
+	DestinationKey.SelectedKeyName = FName("PatrolDestination");
+	PatrolPointKey.AddVectorFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_SelectPatrolPoint, PatrolPointKey));
+	PatrolPoint2Key.AddVectorFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_SelectPatrolPoint, PatrolPoint2Key));
+	DestinationKey.AddVectorFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_SelectPatrolPoint, DestinationKey));
+}
+
+EBTNodeResult::Type UBTTask_SelectPatrolPoint::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	UBlackboardComponent* Blackboard = OwnerComp.GetBlackboardComponent();
+	if (Blackboard == nullptr) return EBTNodeResult::Failed;
+
+	FSelectPatrolPointMemory* Memory = reinterpret_cast<FSelectPatrolPointMemory*>(NodeMemory);
+	const FBlackboardKeySelector& PointKey = Memory->bSecondPointNext ? PatrolPoint2Key : PatrolPointKey;
+	Blackboard->SetValue<UBlackboardKeyType_Vector>(
+		DestinationKey.GetSelectedKeyID(),
+		Blackboard->GetValue<UBlackboardKeyType_Vector>(PointKey.GetSelectedKeyID()));
+	Memory->bSecondPointNext = !Memory->bSecondPointNext;
+
+	return EBTNodeResult::Succeeded;
+}
+
+uint16 UBTTask_SelectPatrolPoint::GetInstanceMemorySize() const
+{
+	return sizeof(FSelectPatrolPointMemory);
+}
+
+void UBTTask_SelectPatrolPoint::InitializeFromAsset(UBehaviorTree& Asset)
+{
+	Super::InitializeFromAsset(Asset);
+
+	UBlackboardData* BlackboardAsset = GetBlackboardAsset();
+	if (BlackboardAsset)
+	{
+		PatrolPointKey.ResolveSelectedKey(*BlackboardAsset);
+		PatrolPoint2Key.ResolveSelectedKey(*BlackboardAsset);
+		DestinationKey.ResolveSelectedKey(*BlackboardAsset);
+	}
+}
+
+FString UBTTask_SelectPatrolPoint::GetStaticDescription() const
+{
+	return FString::Printf(TEXT("%s or %s into %s"),
+		*PatrolPointKey.SelectedKeyName.ToString(),
+		*PatrolPoint2Key.SelectedKeyName.ToString(),
+		*DestinationKey.SelectedKeyName.ToString());
+}
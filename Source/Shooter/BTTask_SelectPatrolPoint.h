@@ -0,0 +1,43 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BTTaskNode.h"
+#include "BTTask_SelectPatrolPoint.generated.h"
+
+/**
+ * Writes the next of the enemy's two patrol points into DestinationKey for a MoveTo,
+ * alternating each time it runs. Which point is next lives in node memory,
+ * so the task needs no UObject per enemy.
+ */
+UCLASS()
+class SHOOTER_API UBTTask_SelectPatrolPoint : public UBTTaskNode
+{
+	GENERATED_BODY()
+
+public:
+	UBTTask_SelectPatrolPoint();
+
+	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual uint16 GetInstanceMemorySize() const override;
+	virtual void InitializeFromAsset(UBehaviorTree& Asset) override;
+	virtual FString GetStaticDescription() const override;
+
+private:
+	/** Behavior tree instance memory starts zeroed, so the first run picks PatrolPoint */
+	struct FSelectPatrolPointMemory
+	{
+		bool bSecondPointNext;
+	};
+
+	UPROPERTY(EditAnywhere, Category = Blackboard)
+	FBlackboardKeySelector PatrolPointKey;
+
+	UPROPERTY(EditAnywhere, Category = Blackboard)
+	FBlackboardKeySelector PatrolPoint2Key;
+
+	/** Where the MoveTo should go */
+	UPROPERTY(EditAnywhere, Category = Blackboard)
+	FBlackboardKeySelector DestinationKey;
+};
@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DroppedWeaponSubsystem.h"
+#include "Shooter.h"
+#include "Weapon.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Dropped Weapons"), STAT_DroppedWeapons, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dropped Weapons Recycled"), STAT_DroppedWeaponsRecycled, STATGROUP_Shooter);
+
+static TAutoConsoleVariable<int32> CVarMaxDroppedWeapons(
+	TEXT("shooter.MaxDroppedWeapons"),
+	12,
+	TEXT("Most thrown weapons left lying in the world before the oldest unseen ones are destroyed."));
+
+static TAutoConsoleVariable<float> CVarDroppedWeaponUnseenTime(
+	TEXT("shooter.DroppedWeaponUnseenTime"),
+	2.f,
+	TEXT("Seconds a dropped weapon must have gone unrendered before it can be recycled."));
+
+UDroppedWeaponSubsystem* UDroppedWeaponSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+	return World ? World->GetSubsystem<UDroppedWeaponSubsystem>() : nullptr;
+}
+
+void UDroppedWeaponSubsystem::RegisterDroppedWeapon(AWeapon* Weapon)
+{
+	if (Weapon == nullptr) return;
+
+	UnregisterDroppedWeapon(Weapon);
+	DroppedWeapons.Add(Weapon);
+	INC_DWORD_STAT(STAT_DroppedWeapons);
+
+	EnforceBudget();
+}
+
+void UDroppedWeaponSubsystem::UnregisterDroppedWeapon(AWeapon* Weapon)
+{
+	const int32 NumRemoved{ DroppedWeapons.Remove(Weapon) };
+	DEC_DWORD_STAT_BY(STAT_DroppedWeapons, NumRemoved);
+}
+
+void UDroppedWeaponSubsystem::EnforceBudget()
+{
+	// Forget weapons destroyed some other way
+	const int32 NumStale{ DroppedWeapons.RemoveAll([](const TWeakObjectPtr<AWeapon>& Weapon) { return !Weapon.IsValid(); }) };
+	DEC_DWORD_STAT_BY(STAT_DroppedWeapons, NumStale);
+
+	const int32 MaxDroppedWeapons{ FMath::Max(CVarMaxDroppedWeapons.GetValueOnGameThread(), 0) };
+	const float UnseenTime{ CVarDroppedWeaponUnseenTime.GetValueOnGameThread() };
+
+	// Oldest first; anything on screen is skipped and stays over budget until a later drop
+	for (int32 i = 0; i < DroppedWeapons.Num() && DroppedWeapons.Num() > MaxDroppedWeapons;)
+	{
+		AWeapon* Weapon = DroppedWeapons[i].Get();
+		if (Weapon->WasRecentlyRendered(UnseenTime))
+		{
+			i++;
+			continue;
+		}
+
+		DroppedWeapons.RemoveAt(i);
+		DEC_DWORD_STAT(STAT_DroppedWeapons);
+		INC_DWORD_STAT(STAT_DroppedWeaponsRecycled);
+		Weapon->Destroy();
+	}
+}
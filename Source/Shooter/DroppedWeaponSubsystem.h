@@ -0,0 +1,34 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DroppedWeaponSubsystem.generated.h"
+
+class AWeapon;
+
+/**
+ * Caps how many thrown weapons can lie around the world. When a new weapon
+ * is dropped past the cap, the oldest one nobody has seen recently is destroyed.
+ */
+UCLASS()
+class SHOOTER_API UDroppedWeaponSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UDroppedWeaponSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Track a weapon that was just thrown, recycling old ones if over budget */
+	void RegisterDroppedWeapon(AWeapon* Weapon);
+
+	/** Stop tracking a weapon that was picked up or destroyed */
+	void UnregisterDroppedWeapon(AWeapon* Weapon);
+
+private:
+	void EnforceBudget();
+
+	/** Dropped weapons, oldest first */
+	TArray<TWeakObjectPtr<AWeapon>> DroppedWeapons;
+};
@@ -14,6 +14,17 @@
 #include "Components/CapsuleComponent.h"
 #include "Components/BoxComponent.h"
 #include "Engine/SkeletalMeshSocket.h"
+#include "Shooter.h"
+#include "FXSubsystem.h"
+#include "PerceptionSubsystem.h"
+#include "EnemySpawnSubsystem.h"
+#include "WorldSnapshot.h"
+#include "ShooterMemory.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemy Mesh Evaluations Skipped"), STAT_EnemyMeshEvalsSkipped, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemy Bone Evaluations Saved"), STAT_EnemyBoneEvalsSaved, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Trace Hit Zone"), STAT_TraceHitZone, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hit Zone Tests"), STAT_HitZoneTests, STATGROUP_Shooter);
 
 // Sets default values
 AEnemy::AEnemy() :
@@ -36,8 +47,13 @@ AEnemy::AEnemy() :
 	bCanAttack(true),
 	AttackWaitTime(1.f),
 	bDying(false),
-	DeathTime(4.f)
+	DeathTime(4.f),
+	VisibleDistanceFactorThresholds({ 0.4f, 0.2f, 0.1f }),
+	NonRenderedUpdateRate(4),
+	MaxEvalRateForInterpolation(4)
 {
+	SHOOTER_LLM_SCOPE(Enemies);
+
  	// Set this character to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
 
@@ -54,16 +70,24 @@ AEnemy::AEnemy() :
 	LeftWeaponCollision->SetupAttachment(GetMesh(), FName("LeftWeaponBone"));
 	RightWeaponCollision = CreateDefaultSubobject<UBoxComponent>(TEXT("Right Weapon Box"));
 	RightWeaponCollision->SetupAttachment(GetMesh(), FName("RightWeaponBone"));
+
+	// Evaluate the skeleton less often when far away or off screen
+	GetMesh()->bEnableUpdateRateOptimizations = true;
+	GetMesh()->OnAnimUpdateRateParamsCreated.BindUObject(this, &AEnemy::SetupUpdateRateParams);
 }
 
 // Called when the game starts or when spawned
 void AEnemy::BeginPlay()
 {
+	SHOOTER_LLM_SCOPE(Enemies);
 	Super::BeginPlay();
 
 	AgroSphere->OnComponentBeginOverlap.AddDynamic(
 		this, 
 		&AEnemy::AgroSphereOverlap);
+	AgroSphere->OnComponentEndOverlap.AddDynamic(
+		this,
+		&AEnemy::AgroSphereEndOverlap);
 	CombatRangeSphere->OnComponentBeginOverlap.AddDynamic(
 		this,
 		&AEnemy::CombatRangeOverlap);
@@ -92,17 +116,14 @@ void AEnemy::BeginPlay()
 		ECollisionChannel::ECC_Pawn,
 		ECollisionResponse::ECR_Overlap);
 	
-	GetMesh()->SetCollisionResponseToChannel(
-		ECollisionChannel::ECC_Visibility, 
-		ECollisionResponse::ECR_Block);
-	// Ignore the camera for Mesh and Capsule
-	GetMesh()->SetCollisionResponseToChannel(
-		ECollisionChannel::ECC_Camera, 
-		ECollisionResponse::ECR_Ignore);
-	GetCapsuleComponent()->SetCollisionResponseToChannel(
-		ECollisionChannel::ECC_Camera,
-		ECollisionResponse::ECR_Ignore
-	);
+	SetupHitCollision();
+
+	// Counts toward the world's alive cap on director spawns
+	UEnemySpawnSubsystem* Spawns = UEnemySpawnSubsystem::Get(this);
+	if (Spawns)
+	{
+		Spawns->RegisterEnemy(this);
+	}
 
 	// Get the AI Controller
 	EnemyController = Cast<AEnemyController>(GetController());
@@ -196,6 +217,7 @@ void AEnemy::ResetHitReactTimer()
 
 void AEnemy::StoreHitNumber(UUserWidget* HitNumber, FVector Location)
 {
+	SHOOTER_LLM_SCOPE(HitNumbers);
 	HitNumbers.Add(HitNumber, Location);
 
 	FTimerHandle HitNumberTimer;
@@ -236,14 +258,26 @@ void AEnemy::AgroSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor*
 	auto Character = Cast<AShooterCharacter>(OtherActor);
 	if (Character)
 	{
-		if (EnemyController)
+		// Only agro once perception has a clear line of sight to the Character
+		UPerceptionSubsystem* Perception = UPerceptionSubsystem::Get(this);
+		if (Perception)
 		{
-			if (EnemyController->GetBlackboardComponent())
-			{
-				EnemyController->GetBlackboardComponent()->SetValueAsObject(
-					TEXT("Target"),
-					Character);
-			}
+			Perception->AddSightRequest(this, Character);
+		}
+	}
+}
+
+void AEnemy::AgroSphereEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
+{
+	if (OtherActor == nullptr) return;
+
+	auto Character = Cast<AShooterCharacter>(OtherActor);
+	if (Character)
+	{
+		UPerceptionSubsystem* Perception = UPerceptionSubsystem::Get(this);
+		if (Perception)
+		{
+			Perception->RemoveSightRequest(this, Character);
 		}
 	}
 }
@@ -260,6 +294,30 @@ void AEnemy::SetStunned(bool Stunned)
 	}
 }
 
+void AEnemy::CaptureSnapshot(FEnemySnapshot& Snapshot) const
+{
+	Snapshot.Health = Health;
+	if (EnemyController == nullptr) return;
+
+	const UBlackboardComponent* Blackboard = EnemyController->GetBlackboardComponent();
+	const AActor* Target = Cast<AActor>(Blackboard->GetValueAsObject(TEXT("Target")));
+	Snapshot.Target = Target ? Target->GetFName() : NAME_None;
+	Snapshot.PatrolPoint = Blackboard->GetValueAsVector(TEXT("PatrolPoint"));
+	Snapshot.PatrolPoint2 = Blackboard->GetValueAsVector(TEXT("PatrolPoint2"));
+}
+
+void AEnemy::RestoreSnapshot(const FEnemySnapshot& Snapshot, AActor* Target)
+{
+	Health = FMath::Clamp(Snapshot.Health, 0.f, MaxHealth);
+	SetStunned(false);
+	if (EnemyController == nullptr) return;
+
+	UBlackboardComponent* Blackboard = EnemyController->GetBlackboardComponent();
+	Blackboard->SetValueAsObject(TEXT("Target"), Target);
+	Blackboard->SetValueAsVector(TEXT("PatrolPoint"), Snapshot.PatrolPoint);
+	Blackboard->SetValueAsVector(TEXT("PatrolPoint2"), Snapshot.PatrolPoint2);
+}
+
 void AEnemy::CombatRangeOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
 	if (OtherActor == nullptr) return;
@@ -318,6 +376,12 @@ void AEnemy::PlayAttackMontage(FName Section, float PlayRate)
 	}
 }
 
+bool AEnemy::IsPlayingAttackMontage() const
+{
+	const UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
+	return AnimInstance && AttackMontage && AnimInstance->Montage_IsPlaying(AttackMontage);
+}
+
 FName AEnemy::GetAttackSectionName()
 {
 	FName SectionName;
@@ -367,13 +431,10 @@ void AEnemy::SpawnBlood(AShooterCharacter* Victim, FName SocketName)
 	if (TipSocket)
 	{
 		const FTransform SocketTransform{ TipSocket->GetSocketTransform(GetMesh()) };
-		if (Victim->GetBloodParticles())
+		UFXSubsystem* FX = UFXSubsystem::Get(this);
+		if (FX && Victim->GetBloodParticles())
 		{
-			UGameplayStatics::SpawnEmitterAtLocation(
-				GetWorld(),
-				Victim->GetBloodParticles(),
-				SocketTransform
-			);
+			FX->SpawnEmitter(Victim->GetBloodParticles(), SocketTransform);
 		}
 	}
 }
@@ -418,6 +479,16 @@ void AEnemy::DestroyEnemy()
 	Destroy();
 }
 
+void AEnemy::SetupUpdateRateParams(FAnimUpdateRateParameters* Params)
+{
+	if (Params == nullptr) return;
+
+	Params->bShouldUseLodMap = false;
+	Params->BaseNonRenderedUpdateRate = NonRenderedUpdateRate;
+	Params->MaxEvalRateForInterpolation = MaxEvalRateForInterpolation;
+	Params->BaseVisibleDistanceFactorThesholds = VisibleDistanceFactorThresholds;
+}
+
 void AEnemy::OnLeftWeaponOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
 	auto Character = Cast<AShooterCharacter>(OtherActor);
@@ -466,6 +537,14 @@ void AEnemy::Tick(float DeltaTime)
 	Super::Tick(DeltaTime);
 
 	UpdateHitNumbers();
+
+	// Count the evaluations skipped by update rate optimization
+	const FAnimUpdateRateParameters* UpdateRateParams{ GetMesh()->AnimUpdateRateParams };
+	if (UpdateRateParams && UpdateRateParams->ShouldSkipEvaluation())
+	{
+		INC_DWORD_STAT(STAT_EnemyMeshEvalsSkipped);
+		INC_DWORD_STAT_BY(STAT_EnemyBoneEvalsSaved, GetMesh()->GetNumBones());
+	}
 }
 
 // Called to bind functionality to input
@@ -481,12 +560,54 @@ void AEnemy::BulletHit_Implementation(FHitResult HitResult, AActor* Shooter, ACo
 	{
 		UGameplayStatics::PlaySoundAtLocation(this, ImpactSound, GetActorLocation());
 	}
-	if (ImpactParticles)
+	UFXSubsystem* FX = UFXSubsystem::Get(this);
+	if (FX && ImpactParticles)
 	{
-		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ImpactParticles, HitResult.Location, FRotator(0.f), true);
+		FX->SpawnImpact(ImpactParticles, HitResult.Location);
 	}
 }
 
+void AEnemy::SetupHitCollision()
+{
+	GetMesh()->SetCollisionResponseToChannel(
+		ECollisionChannel::ECC_Visibility, 
+		ECollisionResponse::ECR_Block);
+	// Weapon traces only see the capsule; TraceHitZone then tests the physics asset
+	GetMesh()->SetCollisionResponseToChannel(
+		ECC_Weapon,
+		ECollisionResponse::ECR_Ignore);
+	GetCapsuleComponent()->SetCollisionResponseToChannel(
+		ECC_Weapon,
+		ECollisionResponse::ECR_Block);
+	AgroSphere->SetCollisionResponseToChannel(
+		ECC_Weapon,
+		ECollisionResponse::ECR_Ignore);
+	CombatRangeSphere->SetCollisionResponseToChannel(
+		ECC_Weapon,
+		ECollisionResponse::ECR_Ignore);
+	// Ignore the camera for Mesh and Capsule
+	GetMesh()->SetCollisionResponseToChannel(
+		ECollisionChannel::ECC_Camera, 
+		ECollisionResponse::ECR_Ignore);
+	GetCapsuleComponent()->SetCollisionResponseToChannel(
+		ECollisionChannel::ECC_Camera,
+		ECollisionResponse::ECR_Ignore
+	);
+}
+
+bool AEnemy::TraceHitZone(
+	FHitResult& OutHitResult,
+	const FVector& Start,
+	const FVector& End,
+	const FCollisionQueryParams& QueryParams) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_TraceHitZone);
+	INC_DWORD_STAT(STAT_HitZoneTests);
+
+	// Per-body test against the physics asset, only once the capsule was hit
+	return GetMesh()->LineTraceComponent(OutHitResult, Start, End, QueryParams);
+}
+
 float AEnemy::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
 	// Set the Target Blackboard Key to agro the Character
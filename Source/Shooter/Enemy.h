@@ -51,6 +51,13 @@ protected:
 		bool bFromSweep,
 		const FHitResult& SweepResult);
 
+	UFUNCTION()
+	void AgroSphereEndOverlap(
+		UPrimitiveComponent* OverlappedComponent,
+		AActor* OtherActor,
+		UPrimitiveComponent* OtherComp,
+		int32 OtherBodyIndex);
+
 	UFUNCTION(BlueprintCallable)
 	void SetStunned(bool Stunned);
 
@@ -70,12 +77,6 @@ protected:
 		UPrimitiveComponent* OtherComp,
 		int32 OtherBodyIndex);
 
-	UFUNCTION(BlueprintCallable)
-	void PlayAttackMontage(FName Section, float PlayRate);
-
-	UFUNCTION(BlueprintPure)
-	FName GetAttackSectionName();
-
 	UFUNCTION()
 	void OnLeftWeaponOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
 	
@@ -106,6 +107,9 @@ protected:
 	UFUNCTION()
 	void DestroyEnemy();
 
+	/** Called when the mesh creates its update rate parameters */
+	void SetupUpdateRateParams(FAnimUpdateRateParameters* Params);
+
 private:
 	/** Particles to spawn when hit by bullets */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
@@ -239,6 +243,18 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	float DeathTime;
 
+	/** Screen size thresholds; each one the mesh falls below adds a skipped frame */
+	UPROPERTY(EditDefaultsOnly, Category = Optimization, meta = (AllowPrivateAccess = "true"))
+	TArray<float> VisibleDistanceFactorThresholds;
+
+	/** Frames between evaluations while the mesh is not rendered */
+	UPROPERTY(EditDefaultsOnly, Category = Optimization, meta = (AllowPrivateAccess = "true"))
+	int32 NonRenderedUpdateRate;
+
+	/** Skipped frames are interpolated up to this evaluation rate */
+	UPROPERTY(EditDefaultsOnly, Category = Optimization, meta = (AllowPrivateAccess = "true"))
+	int32 MaxEvalRateForInterpolation;
+
 public:	
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
@@ -252,8 +268,38 @@ public:
 
 	FORCEINLINE FString GetHeadBone() const { return HeadBone; }
 
+	/** Narrowphase for weapon traces that hit the capsule. Fills in the bone and physical material of the body hit */
+	bool TraceHitZone(
+		FHitResult& OutHitResult,
+		const FVector& Start,
+		const FVector& End,
+		const FCollisionQueryParams& QueryParams) const;
+
+	/** Block weapon traces with the capsule only and other traces with the mesh; called from BeginPlay */
+	void SetupHitCollision();
+
 	UFUNCTION(BlueprintImplementableEvent)
 	void ShowHitNumber(int32 Damage, FVector HitLocation, bool bHeadShot);
 
 	FORCEINLINE UBehaviorTree* GetBehaviorTree() const { return BehaviorTree; }
+
+	/** Called by the attack behavior tree task */
+	UFUNCTION(BlueprintCallable)
+	void PlayAttackMontage(FName Section, float PlayRate);
+
+	UFUNCTION(BlueprintPure)
+	FName GetAttackSectionName();
+
+	bool IsPlayingAttackMontage() const;
+
+	FORCEINLINE bool GetStunned() const { return bStunned; }
+	FORCEINLINE bool GetInAttackRange() const { return bInAttackRange; }
+	FORCEINLINE bool GetCanAttack() const { return bCanAttack; }
+	FORCEINLINE bool GetDying() const { return bDying; }
+
+	/** Save health and blackboard state; the actor part of Snapshot is filled in by the caller */
+	void CaptureSnapshot(struct FEnemySnapshot& Snapshot) const;
+
+	/** Return to a saved state; Target is the actor Snapshot's target name resolved to */
+	void RestoreSnapshot(const struct FEnemySnapshot& Snapshot, AActor* Target);
 };
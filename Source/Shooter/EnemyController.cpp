@@ -6,9 +6,12 @@
 #include "BehaviorTree/BehaviorTreeComponent.h"
 #include "BehaviorTree/BehaviorTree.h"
 #include "Enemy.h"
+#include "ShooterMemory.h"
 
 AEnemyController::AEnemyController()
 {
+	SHOOTER_LLM_SCOPE(AI);
+
 	BlackboardComponent = CreateDefaultSubobject<UBlackboardComponent>(TEXT("BlackboardComponent"));
 	check(BlackboardComponent);
 
@@ -18,6 +21,7 @@ AEnemyController::AEnemyController()
 
 void AEnemyController::OnPossess(APawn* InPawn)
 {
+	SHOOTER_LLM_SCOPE(AI);
 	Super::OnPossess(InPawn);
 	if (InPawn == nullptr) return;
 
@@ -29,4 +33,12 @@ void AEnemyController::OnPossess(APawn* InPawn)
 			BlackboardComponent->InitializeBlackboard(*(Enemy->GetBehaviorTree()->BlackboardAsset));
 		}
 	}
+}
+
+void AEnemyController::TargetSighted(AActor* Target)
+{
+	if (BlackboardComponent->GetValueAsObject(TEXT("Target")) == nullptr)
+	{
+		BlackboardComponent->SetValueAsObject(TEXT("Target"), Target);
+	}
 }
\ No newline at end of file
@@ -17,6 +17,9 @@ public:
 	AEnemyController();
 	virtual void OnPossess(APawn* InPawn) override;
 
+	/** Perception saw Target; chase it unless already chasing something */
+	void TargetSighted(AActor* Target);
+
 private:
 	/** Blackboard component for this enemy */
 	UPROPERTY(BlueprintReadWrite, Category = "AI Behavior", meta = (AllowPrivateAccess = "true"))
@@ -0,0 +1,199 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "EnemyDirector.h"
+#include "Engine/AssetManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Enemy.h"
+#include "EnemyController.h"
+#include "EnemySpawnSubsystem.h"
+#include "Shooter.h"
+#include "ShooterMemory.h"
+
+DECLARE_CYCLE_STAT(TEXT("Enemy Director Spawn"), STAT_EnemyDirectorSpawn, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemies Spawned"), STAT_EnemiesSpawned, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Enemy Spawns Queued"), STAT_EnemySpawnsQueued, STATGROUP_Shooter);
+
+AEnemyDirector::AEnemyDirector() :
+	bStartOnBeginPlay(true),
+	PrewarmWaves(1),
+	CurrentWave(INDEX_NONE),
+	WaveStartTime(0.f),
+	bWaveQueued(false),
+	QueuedSpawns(0),
+	NextSpawnPoint(0)
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+}
+
+void AEnemyDirector::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (WaveTable)
+	{
+		WaveTable->GetAllRows<FEnemyWaveTable>(TEXT("AEnemyDirector::BeginPlay"), Waves);
+	}
+	WaveHandles.SetNum(Waves.Num());
+
+	if (bStartOnBeginPlay)
+	{
+		StartWaves();
+	}
+}
+
+void AEnemyDirector::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	for (TSharedPtr<FStreamableHandle>& Handle : WaveHandles)
+	{
+		if (Handle.IsValid())
+		{
+			Handle->ReleaseHandle();
+		}
+	}
+	WaveHandles.Empty();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AEnemyDirector::StartWaves()
+{
+	if (Waves.Num() == 0) return;
+
+	CurrentWave = 0;
+	bWaveQueued = false;
+	QueuedSpawns = 0;
+	SET_DWORD_STAT(STAT_EnemySpawnsQueued, 0);
+	WaveStartTime = GetWorld()->GetTimeSeconds() + Waves[0]->StartDelay;
+	for (int32 Wave = 0; Wave <= PrewarmWaves && Wave < Waves.Num(); ++Wave)
+	{
+		PrewarmWave(Wave);
+	}
+	SetActorTickEnabled(true);
+}
+
+void AEnemyDirector::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	UpdateWaveStart();
+	SpawnQueued();
+}
+
+void AEnemyDirector::PrewarmWave(int32 WaveIndex)
+{
+	if (!Waves.IsValidIndex(WaveIndex) || WaveHandles[WaveIndex].IsValid()) return;
+
+	// The class brings its hard references with it: mesh, Behavior Tree, montages, sounds
+	const FSoftObjectPath ClassPath{ Waves[WaveIndex]->EnemyClass.ToSoftObjectPath() };
+	if (ClassPath.IsNull()) return;
+	WaveHandles[WaveIndex] = UAssetManager::GetStreamableManager().RequestAsyncLoad(ClassPath);
+}
+
+void AEnemyDirector::UpdateWaveStart()
+{
+	if (!Waves.IsValidIndex(CurrentWave) || bWaveQueued) return;
+
+	const FEnemyWaveTable& Wave = *Waves[CurrentWave];
+	if (GetWorld()->GetTimeSeconds() < WaveStartTime) return;
+	if (Wave.StartWhenAliveAtMost >= 0 && CountAliveEnemies() > Wave.StartWhenAliveAtMost) return;
+
+	// A wave that is still loading waits for it rather than loading synchronously
+	PrewarmWave(CurrentWave);
+	const TSharedPtr<FStreamableHandle>& Handle = WaveHandles[CurrentWave];
+	if (Handle.IsValid() && !Handle->HasLoadCompleted()) return;
+
+	bWaveQueued = true;
+	QueuedSpawns = Wave.EnemyClass.Get() ? Wave.NumEnemies : 0;
+	for (int32 Ahead = 1; Ahead <= PrewarmWaves; ++Ahead)
+	{
+		PrewarmWave(CurrentWave + Ahead);
+	}
+}
+
+void AEnemyDirector::SpawnQueued()
+{
+	if (!Waves.IsValidIndex(CurrentWave) || !bWaveQueued) return;
+	SCOPE_CYCLE_COUNTER(STAT_EnemyDirectorSpawn);
+
+	const FEnemyWaveTable& Wave = *Waves[CurrentWave];
+	UClass* EnemyClass = Wave.EnemyClass.Get();
+	UEnemySpawnSubsystem* Spawns = UEnemySpawnSubsystem::Get(this);
+	while (QueuedSpawns > 0 && Spawns && Spawns->TryReserveSpawn())
+	{
+		// A spawn blocked by collision still uses up budget; the next point is tried next time
+		AEnemy* Enemy = SpawnEnemy(EnemyClass, Wave.bTargetPlayer);
+		if (Enemy)
+		{
+			AliveEnemies.Add(Enemy);
+			--QueuedSpawns;
+			INC_DWORD_STAT(STAT_EnemiesSpawned);
+		}
+	}
+	// How many spawns are waiting on the budget right now, not a running total
+	SET_DWORD_STAT(STAT_EnemySpawnsQueued, QueuedSpawns);
+	if (QueuedSpawns > 0) return;
+
+	// Wave fully spawned: time the next one from now
+	++CurrentWave;
+	bWaveQueued = false;
+	if (Waves.IsValidIndex(CurrentWave))
+	{
+		WaveStartTime = GetWorld()->GetTimeSeconds() + Waves[CurrentWave]->StartDelay;
+	}
+	else
+	{
+		SetActorTickEnabled(false);
+	}
+}
+
+AEnemy* AEnemyDirector::SpawnEnemy(UClass* EnemyClass, bool bTargetPlayer)
+{
+	FTransform SpawnTransform{ GetActorTransform() };
+	for (int32 Tries = 0; Tries < SpawnPoints.Num(); ++Tries)
+	{
+		const AActor* SpawnPoint = SpawnPoints[NextSpawnPoint++ % SpawnPoints.Num()];
+		if (SpawnPoint)
+		{
+			SpawnTransform = FTransform(
+				FRotator(0.f, SpawnPoint->GetActorRotation().Yaw, 0.f),
+				SpawnPoint->GetActorLocation());
+			break;
+		}
+	}
+
+	SHOOTER_LLM_SCOPE(Enemies);
+	AEnemy* Enemy = GetWorld()->SpawnActorDeferred<AEnemy>(
+		EnemyClass,
+		SpawnTransform,
+		this,
+		nullptr,
+		ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButDontSpawnIfColliding);
+	if (Enemy == nullptr) return nullptr;
+
+	// Enemies placed in the level may only auto possess when placed; spawned ones need their controller too
+	Enemy->AutoPossessAI = EAutoPossessAI::PlacedInWorldOrSpawned;
+	Enemy->FinishSpawning(SpawnTransform);
+	if (Enemy->IsPendingKill()) return nullptr;
+
+	if (bTargetPlayer)
+	{
+		AEnemyController* EnemyController = Cast<AEnemyController>(Enemy->GetController());
+		APawn* Player = UGameplayStatics::GetPlayerPawn(this, 0);
+		if (EnemyController && Player)
+		{
+			EnemyController->TargetSighted(Player);
+		}
+	}
+	return Enemy;
+}
+
+int32 AEnemyDirector::CountAliveEnemies()
+{
+	AliveEnemies.RemoveAllSwap([](const TWeakObjectPtr<AEnemy>& Enemy)
+		{
+			return !Enemy.IsValid() || Enemy->GetDying();
+		});
+	return AliveEnemies.Num();
+}
@@ -0,0 +1,116 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Engine/DataTable.h"
+#include "Engine/StreamableManager.h"
+#include "EnemyDirector.generated.h"
+
+class AEnemy;
+
+/** One wave; waves run in row order */
+USTRUCT(BlueprintType)
+struct FEnemyWaveTable : public FTableRowBase
+{
+	GENERATED_BODY()
+
+	/** Loaded, along with its Behavior Tree and montages, before the wave starts */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TSoftClassPtr<AEnemy> EnemyClass;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 NumEnemies = 0;
+
+	/** Seconds after the previous wave has finished spawning */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float StartDelay = 0.f;
+
+	/** Hold the wave until no more than this many of the director's enemies are alive; negative to not wait */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 StartWhenAliveAtMost = -1;
+
+	/** Spawned enemies go straight for the player instead of patrolling */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bTargetPlayer = false;
+};
+
+/**
+ * Spawns the waves in WaveTable at SpawnPoints. Each wave's enemy class is loaded
+ * asynchronously ahead of time, so the wave itself never loads anything. Spawns are
+ * queued and drained under UEnemySpawnSubsystem's world-wide per-frame budget and
+ * alive cap, so a large wave arrives over several frames instead of in one hitch.
+ */
+UCLASS()
+class SHOOTER_API AEnemyDirector : public AActor
+{
+	GENERATED_BODY()
+	
+public:	
+	AEnemyDirector();
+
+	virtual void Tick(float DeltaTime) override;
+
+	/** Start from the first wave; called on BeginPlay when bStartOnBeginPlay */
+	UFUNCTION(BlueprintCallable, Category = Waves)
+	void StartWaves();
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	/** Load the wave's enemy class if it isn't already loading */
+	void PrewarmWave(int32 WaveIndex);
+
+	/** Queue the current wave's enemies once it is loaded and its start conditions are met */
+	void UpdateWaveStart();
+
+	/** Spawn queued enemies, within the world's per-frame budget and alive cap */
+	void SpawnQueued();
+
+	AEnemy* SpawnEnemy(UClass* EnemyClass, bool bTargetPlayer);
+
+	/** Forget enemies that are dead or dying; returns the number left */
+	int32 CountAliveEnemies();
+
+	UPROPERTY(EditAnywhere, Category = Waves, meta = (AllowPrivateAccess = "true"))
+	UDataTable* WaveTable;
+
+	/** Enemies spawn at these actors' transforms, in turn */
+	UPROPERTY(EditInstanceOnly, Category = Waves, meta = (AllowPrivateAccess = "true"))
+	TArray<AActor*> SpawnPoints;
+
+	UPROPERTY(EditAnywhere, Category = Waves, meta = (AllowPrivateAccess = "true"))
+	bool bStartOnBeginPlay;
+
+	/** How many waves ahead to start loading */
+	UPROPERTY(EditAnywhere, Category = Waves, meta = (AllowPrivateAccess = "true"))
+	int32 PrewarmWaves;
+
+	TArray<FEnemyWaveTable*> Waves;
+
+	/** Wave being started or spawned; INDEX_NONE before StartWaves */
+	int32 CurrentWave;
+
+	/** World time the current wave may start */
+	float WaveStartTime;
+
+	bool bWaveQueued;
+
+	/** Enemies of the current wave still to spawn */
+	int32 QueuedSpawns;
+
+	int32 NextSpawnPoint;
+
+	/** Load handles by wave; each keeps its wave's assets loaded until the director goes away */
+	TArray<TSharedPtr<FStreamableHandle>> WaveHandles;
+
+	/** This director's enemies, for StartWhenAliveAtMost */
+	TArray<TWeakObjectPtr<AEnemy>> AliveEnemies;
+
+public:
+	FORCEINLINE int32 GetCurrentWave() const { return CurrentWave; }
+	FORCEINLINE int32 GetNumAliveEnemies() const { return AliveEnemies.Num(); }
+};
@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "EnemySpawnSubsystem.h"
+#include "Shooter.h"
+#include "Enemy.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Enemies Alive"), STAT_EnemiesAlive, STATGROUP_Shooter);
+
+static TAutoConsoleVariable<int32> CVarEnemySpawnsPerFrame(
+	TEXT("shooter.EnemySpawnsPerFrame"),
+	2,
+	TEXT("Most enemies spawned in one frame, across all directors."));
+
+static TAutoConsoleVariable<int32> CVarMaxAliveEnemies(
+	TEXT("shooter.MaxAliveEnemies"),
+	40,
+	TEXT("Directors hold queued spawns while this many enemies are alive in the world. Dying enemies don't count."));
+
+UEnemySpawnSubsystem* UEnemySpawnSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+	return World ? World->GetSubsystem<UEnemySpawnSubsystem>() : nullptr;
+}
+
+void UEnemySpawnSubsystem::RegisterEnemy(AEnemy* Enemy)
+{
+	if (Enemy == nullptr) return;
+
+	AliveEnemies.AddUnique(Enemy);
+	SET_DWORD_STAT(STAT_EnemiesAlive, AliveEnemies.Num());
+}
+
+bool UEnemySpawnSubsystem::TryReserveSpawn()
+{
+	if (BudgetFrame != GFrameCounter)
+	{
+		BudgetFrame = GFrameCounter;
+		SpawnsLeft = CVarEnemySpawnsPerFrame.GetValueOnGameThread();
+		PruneAliveEnemies();
+	}
+
+	// Spawned enemies register from BeginPlay, so AliveEnemies already includes this frame's spawns
+	if (SpawnsLeft <= 0 || AliveEnemies.Num() >= CVarMaxAliveEnemies.GetValueOnGameThread()) return false;
+
+	--SpawnsLeft;
+	return true;
+}
+
+int32 UEnemySpawnSubsystem::GetNumAliveEnemies()
+{
+	PruneAliveEnemies();
+	return AliveEnemies.Num();
+}
+
+void UEnemySpawnSubsystem::PruneAliveEnemies()
+{
+	AliveEnemies.RemoveAllSwap([](const TWeakObjectPtr<AEnemy>& Enemy)
+		{
+			return !Enemy.IsValid() || Enemy->GetDying();
+		});
+	SET_DWORD_STAT(STAT_EnemiesAlive, AliveEnemies.Num());
+}
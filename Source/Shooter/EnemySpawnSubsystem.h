@@ -0,0 +1,44 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemySpawnSubsystem.generated.h"
+
+class AEnemy;
+
+/**
+ * World-wide limits on enemy spawning, shared by every AEnemyDirector in the world:
+ * a cap on how many enemies are alive, placed or spawned, and a per-frame spawn budget.
+ */
+UCLASS()
+class SHOOTER_API UEnemySpawnSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UEnemySpawnSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Count Enemy as alive until it is dying or destroyed; called from its BeginPlay */
+	void RegisterEnemy(AEnemy* Enemy);
+
+	/**
+	* Take one spawn from this frame's budget
+	* @return False once this frame's budget is used up or shooter.MaxAliveEnemies are alive
+	*/
+	bool TryReserveSpawn();
+
+	/** Enemies alive in the world, not counting dying ones */
+	int32 GetNumAliveEnemies();
+
+private:
+	/** Forget enemies that are dead or dying */
+	void PruneAliveEnemies();
+
+	TArray<TWeakObjectPtr<AEnemy>> AliveEnemies;
+
+	/** Frame SpawnsLeft belongs to */
+	uint64 BudgetFrame{ 0 };
+	int32 SpawnsLeft{ 0 };
+};
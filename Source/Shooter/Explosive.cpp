@@ -9,6 +9,7 @@
 #include "Components/SphereComponent.h"
 #include "Enemy.h"
 #include "Kismet/GameplayStatics.h"
+#include "Shooter.h"
 
 // Sets default values
 AExplosive::AExplosive() :
@@ -22,6 +23,8 @@ AExplosive::AExplosive() :
 
 	OverlapSphere = CreateDefaultSubobject<USphereComponent>(TEXT("OverlapSphere"));
 	OverlapSphere->SetupAttachment(GetRootComponent());
+	// Overlap spheres must not stop bullets
+	OverlapSphere->SetCollisionResponseToChannel(ECC_Weapon, ECollisionResponse::ECR_Ignore);
 }
 
 // Called when the game starts or when spawned
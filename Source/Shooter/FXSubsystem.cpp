@@ -0,0 +1,190 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FXSubsystem.h"
+#include "Shooter.h"
+#include "Particles/ParticleSystem.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/WorldSettings.h"
+#include "ShooterMemory.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("FX Components Allocated"), STAT_FXComponentsAllocated, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("FX Spawns Culled"), STAT_FXSpawnsCulled, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("FX Impacts Merged"), STAT_FXImpactsMerged, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("FX Pooled Components"), STAT_FXPooledComponents, STATGROUP_Shooter);
+
+static TAutoConsoleVariable<int32> CVarFXSpawnBudget(
+	TEXT("shooter.FXSpawnBudget"),
+	32,
+	TEXT("Most pooled particle effects spawned per frame."));
+
+static TAutoConsoleVariable<float> CVarFXCullDistance(
+	TEXT("shooter.FXCullDistance"),
+	8000.f,
+	TEXT("Pooled particle effects further than this from the camera are not spawned."));
+
+static TAutoConsoleVariable<float> CVarFXImpactMergeDistance(
+	TEXT("shooter.FXImpactMergeDistance"),
+	20.f,
+	TEXT("Impacts of the same system closer than this in one frame play once."));
+
+static TAutoConsoleVariable<int32> CVarFXPoolSize(
+	TEXT("shooter.FXPoolSize"),
+	16,
+	TEXT("Most idle components kept per particle system."));
+
+void UFXSubsystem::Deinitialize()
+{
+	for (TPair<UParticleSystem*, FFXPool>& Pool : Pools)
+	{
+		for (UParticleSystemComponent* Component : Pool.Value.FreeComponents)
+		{
+			if (Component)
+			{
+				Component->DestroyComponent();
+			}
+		}
+		DEC_DWORD_STAT_BY(STAT_FXPooledComponents, Pool.Value.FreeComponents.Num());
+	}
+	Pools.Empty();
+
+	Super::Deinitialize();
+}
+
+UFXSubsystem* UFXSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+	return World ? World->GetSubsystem<UFXSubsystem>() : nullptr;
+}
+
+UParticleSystemComponent* UFXSubsystem::SpawnEmitter(UParticleSystem* Template, const FTransform& Transform)
+{
+	if (Template == nullptr) return nullptr;
+
+	BeginFrame();
+	if (!ShouldSpawn(Transform.GetLocation())) return nullptr;
+
+	SHOOTER_LLM_SCOPE(FX);
+	UParticleSystemComponent* Component = AcquireComponent(Template);
+	Component->SetWorldTransform(Transform);
+	Component->ActivateSystem(true);
+	++SpawnsThisFrame;
+
+	return Component;
+}
+
+UParticleSystemComponent* UFXSubsystem::SpawnImpact(UParticleSystem* Template, const FVector& Location, const FRotator& Rotation)
+{
+	if (Template == nullptr) return nullptr;
+
+	BeginFrame();
+	const float MergeDistanceSquared{ FMath::Square(CVarFXImpactMergeDistance.GetValueOnGameThread()) };
+	for (const FFrameImpact& Impact : FrameImpacts)
+	{
+		if (Impact.Template == Template &&
+			FVector::DistSquared(Impact.Location, Location) <= MergeDistanceSquared)
+		{
+			INC_DWORD_STAT(STAT_FXImpactsMerged);
+			return Impact.Component.Get();
+		}
+	}
+
+	UParticleSystemComponent* Component = SpawnEmitter(Template, FTransform(Rotation, Location));
+	if (Component)
+	{
+		FrameImpacts.Add({ Template, Location, Component });
+	}
+	return Component;
+}
+
+bool UFXSubsystem::ShouldSpawn(const FVector& Location)
+{
+	UWorld* World = GetWorld();
+	if (World == nullptr || World->GetNetMode() == NM_DedicatedServer) return false;
+
+	if (SpawnsThisFrame >= CVarFXSpawnBudget.GetValueOnGameThread())
+	{
+		INC_DWORD_STAT(STAT_FXSpawnsCulled);
+		return false;
+	}
+
+	APlayerCameraManager* CameraManager = UGameplayStatics::GetPlayerCameraManager(World, 0);
+	if (CameraManager == nullptr) return true;
+
+	const FVector ToLocation{ Location - CameraManager->GetCameraLocation() };
+	const float DistanceSquared{ ToLocation.SizeSquared() };
+	if (DistanceSquared > FMath::Square(CVarFXCullDistance.GetValueOnGameThread()))
+	{
+		INC_DWORD_STAT(STAT_FXSpawnsCulled);
+		return false;
+	}
+
+	// Effects right next to the camera can spill into view even when their origin is behind it
+	if (DistanceSquared > FMath::Square(500.f))
+	{
+		// Half the horizontal FOV plus a margin for effects with some size to them
+		const float HalfAngle{ FMath::DegreesToRadians(FMath::Min(CameraManager->GetFOVAngle() * 0.5f + 15.f, 180.f)) };
+		const FVector CameraForward{ CameraManager->GetCameraRotation().Vector() };
+		if (FVector::DotProduct(ToLocation.GetSafeNormal(), CameraForward) < FMath::Cos(HalfAngle))
+		{
+			INC_DWORD_STAT(STAT_FXSpawnsCulled);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void UFXSubsystem::BeginFrame()
+{
+	if (CurrentFrame == GFrameCounter) return;
+
+	CurrentFrame = GFrameCounter;
+	SpawnsThisFrame = 0;
+	FrameImpacts.Reset();
+}
+
+UParticleSystemComponent* UFXSubsystem::AcquireComponent(UParticleSystem* Template)
+{
+	FFXPool& Pool = Pools.FindOrAdd(Template);
+	while (Pool.FreeComponents.Num() > 0)
+	{
+		UParticleSystemComponent* Component = Pool.FreeComponents.Pop(false);
+		DEC_DWORD_STAT(STAT_FXPooledComponents);
+		if (Component && !Component->IsPendingKill())
+		{
+			return Component;
+		}
+	}
+
+	// Outer is the world settings, like components from UGameplayStatics::SpawnEmitterAtLocation
+	UWorld* World = GetWorld();
+	UParticleSystemComponent* Component = NewObject<UParticleSystemComponent>(World->GetWorldSettings());
+	Component->bAutoActivate = false;
+	Component->bAutoDestroy = false;
+	Component->SetAbsolute(true, true, true);
+	Component->SetTemplate(Template);
+	Component->OnSystemFinished.AddDynamic(this, &UFXSubsystem::OnSystemFinished);
+	Component->RegisterComponentWithWorld(World);
+	INC_DWORD_STAT(STAT_FXComponentsAllocated);
+
+	return Component;
+}
+
+void UFXSubsystem::OnSystemFinished(UParticleSystemComponent* Component)
+{
+	if (Component == nullptr || Component->IsPendingKill()) return;
+
+	FFXPool* Pool = Pools.Find(Component->Template);
+	if (Pool && Pool->FreeComponents.Num() < CVarFXPoolSize.GetValueOnGameThread())
+	{
+		Pool->FreeComponents.Add(Component);
+		INC_DWORD_STAT(STAT_FXPooledComponents);
+		return;
+	}
+
+	// Pool is full; let this one go
+	Component->DestroyComponent();
+}
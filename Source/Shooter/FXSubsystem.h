@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FXSubsystem.generated.h"
+
+class UParticleSystem;
+class UParticleSystemComponent;
+
+/** Idle components for one particle system */
+USTRUCT()
+struct FFXPool
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<UParticleSystemComponent*> FreeComponents;
+};
+
+/**
+ * Spawns one-shot particle effects from per-system pools of components.
+ * Spawns are skipped when they are too far away, out of view or over this
+ * frame's budget, and impacts landing on top of one another in the same
+ * frame are merged into one.
+ */
+UCLASS()
+class SHOOTER_API UFXSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	static UFXSubsystem* Get(const UObject* WorldContextObject);
+
+	/**
+	* Play Template at Transform
+	* @return The playing component, or null if the spawn was culled
+	*/
+	UParticleSystemComponent* SpawnEmitter(UParticleSystem* Template, const FTransform& Transform);
+
+	/** Like SpawnEmitter, but reuses an impact of the same system already spawned this frame close to Location */
+	UParticleSystemComponent* SpawnImpact(UParticleSystem* Template, const FVector& Location, const FRotator& Rotation = FRotator::ZeroRotator);
+
+private:
+	/** True if an effect at Location is worth spawning this frame */
+	bool ShouldSpawn(const FVector& Location);
+
+	/** Start a new frame's budget and impact list if the frame has changed */
+	void BeginFrame();
+
+	UParticleSystemComponent* AcquireComponent(UParticleSystem* Template);
+
+	UFUNCTION()
+	void OnSystemFinished(UParticleSystemComponent* Component);
+
+	UPROPERTY()
+	TMap<UParticleSystem*, FFXPool> Pools;
+
+	/** An impact spawned this frame, for merging */
+	struct FFrameImpact
+	{
+		UParticleSystem* Template;
+		FVector Location;
+		TWeakObjectPtr<UParticleSystemComponent> Component;
+	};
+	TArray<FFrameImpact, TInlineAllocator<16>> FrameImpacts;
+
+	/** Frame SpawnsThisFrame and FrameImpacts belong to */
+	uint64 CurrentFrame{ 0 };
+
+	int32 SpawnsThisFrame{ 0 };
+};
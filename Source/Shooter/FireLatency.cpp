@@ -0,0 +1,173 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FireLatency.h"
+#include "Misc/CoreDelegates.h"
+#include "RenderingThread.h"
+#include "Async/Async.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Shooter.h"
+
+#if WITH_FIRE_LATENCY_TRACKER
+
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Fire Latency Input To Accept (ms)"), STAT_FireLatencyInputToAccept, STATGROUP_Shooter);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Fire Latency Gating Delay (ms)"), STAT_FireLatencyGatingDelay, STATGROUP_Shooter);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Fire Latency Accept To Trace (ms)"), STAT_FireLatencyAcceptToTrace, STATGROUP_Shooter);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Fire Latency Muzzle To Present (ms)"), STAT_FireLatencyMuzzleToPresent, STATGROUP_Shooter);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Fire Latency Input To Present (ms)"), STAT_FireLatencyInputToPresent, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Fire Presses Gated"), STAT_FirePressesGated, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Fire Presses Dropped"), STAT_FirePressesDropped, STATGROUP_Shooter);
+
+CSV_DEFINE_CATEGORY(ShooterFireLatency, true);
+
+static FAutoConsoleCommand DumpFireLatencyCommand(
+	TEXT("shooter.DumpFireLatency"),
+	TEXT("Log the fire latency histograms (ms) for the local player's shots."),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		FFireLatencyTracker::Get().DumpToLog();
+	}));
+
+static FAutoConsoleCommand ResetFireLatencyCommand(
+	TEXT("shooter.ResetFireLatency"),
+	TEXT("Clear the fire latency histograms."),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		FFireLatencyTracker::Get().Reset();
+	}));
+
+static double ToMs(double Seconds)
+{
+	return Seconds * 1000.;
+}
+
+FFireLatencyTracker& FFireLatencyTracker::Get()
+{
+	static FFireLatencyTracker Tracker;
+	return Tracker;
+}
+
+FFireLatencyTracker::FFireLatencyTracker()
+{
+	Reset();
+	FCoreDelegates::OnEndFrame.AddRaw(this, &FFireLatencyTracker::OnEndFrame);
+}
+
+void FFireLatencyTracker::MarkInput()
+{
+	Pending = FSample{};
+	Pending.InputTime = FPlatformTime::Seconds();
+	Pending.InputFrame = GFrameCounter;
+	bPendingActive = true;
+}
+
+void FFireLatencyTracker::MarkRelease()
+{
+	if (bPendingActive && Pending.AcceptTime == 0.)
+	{
+		INC_DWORD_STAT(STAT_FirePressesDropped);
+		bPendingActive = false;
+	}
+}
+
+void FFireLatencyTracker::MarkAccepted()
+{
+	if (!bPendingActive || Pending.AcceptTime != 0.) return;
+
+	Pending.AcceptTime = FPlatformTime::Seconds();
+
+	// Accepted on a later frame than the press means it waited on CombatState or the fire timer
+	Pending.bGated = GFrameCounter != Pending.InputFrame;
+	if (Pending.bGated)
+	{
+		INC_DWORD_STAT(STAT_FirePressesGated);
+	}
+}
+
+void FFireLatencyTracker::MarkMuzzleFlash()
+{
+	if (bPendingActive && Pending.AcceptTime != 0. && Pending.MuzzleTime == 0.)
+	{
+		Pending.MuzzleTime = FPlatformTime::Seconds();
+	}
+}
+
+void FFireLatencyTracker::MarkTraceResolved()
+{
+	if (bPendingActive && Pending.AcceptTime != 0. && Pending.TraceTime == 0.)
+	{
+		Pending.TraceTime = FPlatformTime::Seconds();
+	}
+}
+
+void FFireLatencyTracker::OnEndFrame()
+{
+	if (!bPendingActive || Pending.MuzzleTime == 0. || Pending.TraceTime == 0.) return;
+	bPendingActive = false;
+
+	// Runs after this frame's scene and viewport commands, so it stamps roughly when the frame is presented
+	const FSample Sample{ Pending };
+	ENQUEUE_RENDER_COMMAND(ShooterFireLatencyPresent)(
+		[Sample](FRHICommandListImmediate& RHICmdList)
+		{
+			const double PresentTime{ FPlatformTime::Seconds() };
+			AsyncTask(ENamedThreads::GameThread, [Sample, PresentTime]()
+			{
+				FFireLatencyTracker::Get().RecordPresented(Sample, PresentTime);
+			});
+		});
+}
+
+void FFireLatencyTracker::RecordPresented(const FSample& Sample, double PresentTime)
+{
+	const double InputToAcceptMs{ ToMs(Sample.AcceptTime - Sample.InputTime) };
+	const double AcceptToMuzzleMs{ ToMs(Sample.MuzzleTime - Sample.AcceptTime) };
+	const double AcceptToTraceMs{ ToMs(Sample.TraceTime - Sample.AcceptTime) };
+	const double MuzzleToPresentMs{ ToMs(PresentTime - Sample.MuzzleTime) };
+	const double InputToPresentMs{ ToMs(PresentTime - Sample.InputTime) };
+
+	InputToAccept.AddMeasurement(InputToAcceptMs);
+	AcceptToMuzzle.AddMeasurement(AcceptToMuzzleMs);
+	AcceptToTrace.AddMeasurement(AcceptToTraceMs);
+	MuzzleToPresent.AddMeasurement(MuzzleToPresentMs);
+	InputToPresent.AddMeasurement(InputToPresentMs);
+	if (Sample.bGated)
+	{
+		GatingDelay.AddMeasurement(InputToAcceptMs);
+	}
+
+	// Stats show the running averages; the CSV gets every shot
+	SET_FLOAT_STAT(STAT_FireLatencyInputToAccept, InputToAccept.GetAverageOfAllMeasures());
+	SET_FLOAT_STAT(STAT_FireLatencyGatingDelay, GatingDelay.GetAverageOfAllMeasures());
+	SET_FLOAT_STAT(STAT_FireLatencyAcceptToTrace, AcceptToTrace.GetAverageOfAllMeasures());
+	SET_FLOAT_STAT(STAT_FireLatencyMuzzleToPresent, MuzzleToPresent.GetAverageOfAllMeasures());
+	SET_FLOAT_STAT(STAT_FireLatencyInputToPresent, InputToPresent.GetAverageOfAllMeasures());
+
+	CSV_CUSTOM_STAT(ShooterFireLatency, InputToAcceptMs, InputToAcceptMs, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(ShooterFireLatency, AcceptToTraceMs, AcceptToTraceMs, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(ShooterFireLatency, MuzzleToPresentMs, MuzzleToPresentMs, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(ShooterFireLatency, InputToPresentMs, InputToPresentMs, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(ShooterFireLatency, GatedPresses, Sample.bGated ? 1 : 0, ECsvCustomStatOp::Accumulate);
+}
+
+void FFireLatencyTracker::Reset()
+{
+	// 5 ms bins up to a quarter second; anything slower lands in the last bin
+	for (FHistogram* Histogram : { &InputToAccept, &GatingDelay, &AcceptToMuzzle, &AcceptToTrace, &MuzzleToPresent, &InputToPresent })
+	{
+		Histogram->InitLinear(0., 250., 5.);
+	}
+	bPendingActive = false;
+}
+
+void FFireLatencyTracker::DumpToLog()
+{
+	InputToAccept.DumpToLog(TEXT("Fire Latency: Input To Accept (ms)"));
+	GatingDelay.DumpToLog(TEXT("Fire Latency: Gating Delay, gated presses only (ms)"));
+	AcceptToMuzzle.DumpToLog(TEXT("Fire Latency: Accept To Muzzle Flash (ms)"));
+	AcceptToTrace.DumpToLog(TEXT("Fire Latency: Accept To Trace Resolved (ms)"));
+	MuzzleToPresent.DumpToLog(TEXT("Fire Latency: Muzzle Flash To Present (ms)"));
+	InputToPresent.DumpToLog(TEXT("Fire Latency: Input To Present (ms)"));
+}
+
+#endif
@@ -0,0 +1,90 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/Histogram.h"
+
+/** Shipping builds get an empty tracker, so the calls in the fire path compile away */
+#define WITH_FIRE_LATENCY_TRACKER !UE_BUILD_SHIPPING
+
+#if WITH_FIRE_LATENCY_TRACKER
+
+/**
+ * Measures how long the local player's shots take from the fire button to the screen.
+ * Only the first shot of each press is followed; automatic follow-up shots aren't input driven.
+ * Times are real time (FPlatformTime), so hitches and gating all show up.
+ */
+class FFireLatencyTracker
+{
+public:
+	static FFireLatencyTracker& Get();
+
+	/** Fire button went down */
+	void MarkInput();
+
+	/** Fire button came up; a press that never fired was dropped by gating */
+	void MarkRelease();
+
+	/** FireWeapon passed the CombatState and ammo checks */
+	void MarkAccepted();
+
+	void MarkMuzzleFlash();
+
+	/** The shot's hits are known */
+	void MarkTraceResolved();
+
+	void Reset();
+	void DumpToLog();
+
+private:
+	/** Timestamps for the shot being followed, 0 until reached */
+	struct FSample
+	{
+		double InputTime{ 0. };
+		double AcceptTime{ 0. };
+		double MuzzleTime{ 0. };
+		double TraceTime{ 0. };
+		uint64 InputFrame{ 0 };
+		bool bGated{ false };
+	};
+
+	FFireLatencyTracker();
+
+	/** Once the frame that fired the shot is over, stamp it when the render thread presents it */
+	void OnEndFrame();
+	void RecordPresented(const FSample& Sample, double PresentTime);
+
+	FSample Pending;
+	bool bPendingActive{ false };
+
+	FHistogram InputToAccept;
+	/** Only presses that had to wait on CombatState or the auto fire timer */
+	FHistogram GatingDelay;
+	FHistogram AcceptToMuzzle;
+	FHistogram AcceptToTrace;
+	FHistogram MuzzleToPresent;
+	FHistogram InputToPresent;
+};
+
+#else
+
+class FFireLatencyTracker
+{
+public:
+	static FFireLatencyTracker& Get()
+	{
+		static FFireLatencyTracker Tracker;
+		return Tracker;
+	}
+
+	void MarkInput() {}
+	void MarkRelease() {}
+	void MarkAccepted() {}
+	void MarkMuzzleFlash() {}
+	void MarkTraceResolved() {}
+	void Reset() {}
+	void DumpToLog() {}
+};
+
+#endif
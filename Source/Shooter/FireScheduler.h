@@ -0,0 +1,33 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Fire clock for automatic weapons. Each shot is scheduled exactly one fire
+ * interval after the previous shot's due time rather than after the frame it
+ * was fired on, so the rate of fire doesn't depend on the frame rate.
+ */
+struct FFireScheduler
+{
+	/** A shot went off at ShotTime; the next one is due Interval later */
+	void ShotFired(double ShotTime, float Interval)
+	{
+		NextShotTime = ShotTime + Interval;
+	}
+
+	bool IsShotDue(double Now) const { return Now >= NextShotTime; }
+
+	/** When the next shot is due; may be earlier than the current frame */
+	double GetNextShotTime() const { return NextShotTime; }
+
+	/** Drop any backlog of overdue shots */
+	void CatchUp(double Now)
+	{
+		NextShotTime = FMath::Max(NextShotTime, Now);
+	}
+
+private:
+	double NextShotTime{ 0.0 };
+};
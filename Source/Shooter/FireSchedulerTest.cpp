@@ -0,0 +1,73 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+#include "FireScheduler.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFireSchedulerRateTest, "Shooter.FireScheduler.RateIndependentOfFrameRate",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FFireSchedulerRateTest::RunTest(const FString& Parameters)
+{
+	const float FrameRates[] = { 20.f, 30.f, 45.f, 60.f, 90.f, 120.f, 144.f, 240.f };
+	const float FireIntervals[] = { 0.05f, 0.1f, 0.13f };
+	const double Duration{ 10.0 };
+
+	for (const float FireInterval : FireIntervals)
+	{
+		// One shot on the press, then one every interval for the whole hold
+		const int32 ExpectedShots{ 1 + FMath::FloorToInt(Duration / FireInterval) };
+
+		for (const float FrameRate : FrameRates)
+		{
+			// Fire on the first frame, then run frames the way UpdateAutoFire does
+			FFireScheduler Scheduler;
+			Scheduler.ShotFired(0.0, FireInterval);
+			int32 Shots{ 1 };
+			double LastShotTime{ 0.0 };
+			bool bEvenlySpaced{ true };
+
+			const int32 NumFrames{ FMath::CeilToInt(Duration * FrameRate) };
+			for (int32 Frame = 1; Frame <= NumFrames; Frame++)
+			{
+				const double Now{ FMath::Min(Frame / static_cast<double>(FrameRate), Duration) };
+				while (Scheduler.IsShotDue(Now))
+				{
+					const double ShotTime{ Scheduler.GetNextShotTime() };
+					bEvenlySpaced &= FMath::IsNearlyEqual(ShotTime - LastShotTime, static_cast<double>(FireInterval), 1e-6);
+					LastShotTime = ShotTime;
+					Scheduler.ShotFired(ShotTime, FireInterval);
+					++Shots;
+				}
+			}
+
+			const FString Case{ FString::Printf(TEXT("%.2fs interval at %.0f fps"), FireInterval, FrameRate) };
+			TestEqual(Case + TEXT(": shots in 10s"), Shots, ExpectedShots);
+			TestTrue(Case + TEXT(": shots are timestamped one interval apart"), bEvenlySpaced);
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFireSchedulerCatchUpTest, "Shooter.FireScheduler.CatchUpDropsBacklog",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FFireSchedulerCatchUpTest::RunTest(const FString& Parameters)
+{
+	FFireScheduler Scheduler;
+	Scheduler.ShotFired(0.0, 0.1f);
+
+	// A one second hitch leaves ten shots overdue; catching up keeps only the next one
+	Scheduler.CatchUp(1.0);
+	TestTrue(TEXT("A shot is due right after catching up"), Scheduler.IsShotDue(1.0));
+	Scheduler.ShotFired(Scheduler.GetNextShotTime(), 0.1f);
+	TestFalse(TEXT("No backlog after the caught up shot"), Scheduler.IsShotDue(1.0));
+	TestEqual(TEXT("Next shot one interval after the hitch"), Scheduler.GetNextShotTime(), 1.1, 1e-6);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,353 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FlowFieldSubsystem.h"
+#include "Shooter.h"
+#include "NavigationSystem.h"
+#include "NavigationData.h"
+#include "ShooterMemory.h"
+
+DECLARE_CYCLE_STAT(TEXT("Flow Field Tick"), STAT_FlowFieldTick, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Flow Field Sample"), STAT_FlowFieldSample, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Flow Field Cells Expanded"), STAT_FlowFieldCellsExpanded, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Flow Field Navmesh Projections"), STAT_FlowFieldProjections, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Flow Fields"), STAT_FlowFields, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Flow Field Cached Heights"), STAT_FlowFieldCachedHeights, STATGROUP_Shooter);
+
+static TAutoConsoleVariable<float> CVarFlowFieldCellSize(
+	TEXT("shooter.FlowFieldCellSize"),
+	100.f,
+	TEXT("Width of one flow field cell."));
+
+static TAutoConsoleVariable<int32> CVarFlowFieldRadius(
+	TEXT("shooter.FlowFieldRadius"),
+	40,
+	TEXT("Cells from a chase target to the edge of its flow field. Chasers beyond it use normal paths."));
+
+static TAutoConsoleVariable<float> CVarFlowFieldUpdateInterval(
+	TEXT("shooter.FlowFieldUpdateInterval"),
+	0.25f,
+	TEXT("Seconds between flow field rebuilds, when the target has moved to another cell."));
+
+static TAutoConsoleVariable<int32> CVarFlowFieldCellsPerFrame(
+	TEXT("shooter.FlowFieldCellsPerFrame"),
+	1024,
+	TEXT("Most flow field cells expanded per frame across all fields."));
+
+namespace
+{
+	constexpr uint16 UnreachedSteps{ MAX_uint16 };
+	constexpr float UnwalkableHeight{ TNumericLimits<float>::Lowest() };
+
+	/** Largest height change between neighbouring cells that still counts as connected */
+	constexpr float MaxCellStepHeight{ 75.f };
+
+	/** Fields nobody has sampled for this long are dropped */
+	constexpr float FieldIdleTime{ 2.f };
+
+	/** In opposite pairs: the reverse of offset i is offset i ^ 1 */
+	const FIntPoint NeighbourOffsets[]{
+		{ 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 },
+		{ 1, 1 }, { -1, -1 }, { 1, -1 }, { -1, 1 } };
+}
+
+void UFlowFieldSubsystem::Deinitialize()
+{
+	if (UNavigationSystemV1* NavSystem = BoundNavSystem.Get())
+	{
+		NavSystem->OnNavigationGenerationFinishedDelegate.RemoveDynamic(this, &UFlowFieldSubsystem::OnNavigationGenerationFinished);
+	}
+	BoundNavSystem.Reset();
+
+	Super::Deinitialize();
+}
+
+UFlowFieldSubsystem* UFlowFieldSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+	return World ? World->GetSubsystem<UFlowFieldSubsystem>() : nullptr;
+}
+
+int32 UFlowFieldSubsystem::GetFieldSize() const
+{
+	return CVarFlowFieldRadius.GetValueOnGameThread() * 2 + 1;
+}
+
+FIntPoint UFlowFieldSubsystem::WorldToCell(const FVector& Location) const
+{
+	const float CellSize{ CVarFlowFieldCellSize.GetValueOnGameThread() };
+	return FIntPoint(
+		FMath::FloorToInt(Location.X / CellSize),
+		FMath::FloorToInt(Location.Y / CellSize));
+}
+
+FVector UFlowFieldSubsystem::CellToWorld(const FIntPoint& Cell) const
+{
+	const float CellSize{ CVarFlowFieldCellSize.GetValueOnGameThread() };
+	return FVector((Cell.X + 0.5f) * CellSize, (Cell.Y + 0.5f) * CellSize, 0.f);
+}
+
+EFlowFieldSample UFlowFieldSubsystem::SampleDirection(AActor* Target, const FVector& Location, FVector& OutDirection)
+{
+	SCOPE_CYCLE_COUNTER(STAT_FlowFieldSample);
+	if (Target == nullptr) return EFlowFieldSample::NoPath;
+
+	FFlowField* Field = Fields.FindByPredicate([Target](const FFlowField& Candidate)
+		{
+			return Candidate.Target == Target;
+		});
+	if (Field == nullptr)
+	{
+		// Built from the next tick on
+		Field = &Fields.AddDefaulted_GetRef();
+		Field->Target = Target;
+		SET_DWORD_STAT(STAT_FlowFields, Fields.Num());
+	}
+	Field->LastSampledTime = GetWorld()->GetTimeSeconds();
+	if (Field->Steps.Num() == 0) return EFlowFieldSample::Building;
+
+	const int32 Size{ Field->Size };
+
+	const FIntPoint Local{ WorldToCell(Location) - Field->Origin };
+	if (Local.X < 0 || Local.Y < 0 || Local.X >= Size || Local.Y >= Size) return EFlowFieldSample::NoPath;
+
+	const int32 Index{ Local.Y * Size + Local.X };
+	const uint16 Steps{ Field->Steps[Index] };
+	if (Steps == UnreachedSteps) return EFlowFieldSample::NoPath;
+
+	// Head for the cell the build reached this one from, so the step passed its height and corner checks
+	const FVector Goal{ Steps > 0 ?
+		CellToWorld(Field->Origin + Local + NeighbourOffsets[Field->NextStep[Index]]) :
+		Target->GetActorLocation() };
+
+	OutDirection = (Goal - Location).GetSafeNormal2D();
+	return OutDirection.IsNearlyZero() ? EFlowFieldSample::NoPath : EFlowFieldSample::Direction;
+}
+
+void UFlowFieldSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_FlowFieldTick);
+
+	const float Now{ GetWorld()->GetTimeSeconds() };
+	const float UpdateInterval{ CVarFlowFieldUpdateInterval.GetValueOnGameThread() };
+	int32 CellsLeft{ CVarFlowFieldCellsPerFrame.GetValueOnGameThread() };
+
+	const int32 NumFields{ Fields.Num() };
+	Fields.RemoveAllSwap([Now](const FFlowField& Field)
+		{
+			return !Field.Target.IsValid() || Now - Field.LastSampledTime > FieldIdleTime;
+		});
+	if (Fields.Num() != NumFields)
+	{
+		SET_DWORD_STAT(STAT_FlowFields, Fields.Num());
+	}
+
+	// Room for every field and its rebuild to cover different cells; past that, cells left behind are dropped
+	const int32 FieldCells{ FMath::Square(GetFieldSize()) };
+	if (CellHeights.Num() > FMath::Max(Fields.Num(), 1) * FieldCells * 2)
+	{
+		EvictUncoveredCells();
+	}
+
+	for (FFlowField& Field : Fields)
+	{
+		if (!Field.bBuilding && (Field.LastBuildStartTime < 0.f || Now - Field.LastBuildStartTime >= UpdateInterval))
+		{
+			// Until the navmesh changes, a target that stayed in its cell keeps its field
+			const FVector TargetLocation{ Field.Target->GetActorLocation() };
+			if (Field.Steps.Num() == 0 || Field.bStale || WorldToCell(TargetLocation) != Field.GoalCell)
+			{
+				StartBuild(Field, TargetLocation);
+			}
+			Field.LastBuildStartTime = Now;
+		}
+
+		if (Field.bBuilding && CellsLeft > 0)
+		{
+			CellsLeft -= ContinueBuild(Field, CellsLeft);
+		}
+	}
+}
+
+void UFlowFieldSubsystem::StartBuild(FFlowField& Field, const FVector& TargetLocation)
+{
+	SHOOTER_LLM_SCOPE(AI);
+	const int32 Size{ GetFieldSize() };
+	Field.BuildSize = Size;
+	Field.BuildGoalCell = WorldToCell(TargetLocation);
+	Field.BuildOrigin = Field.BuildGoalCell - FIntPoint(Size / 2, Size / 2);
+	Field.BuildSteps.Init(UnreachedSteps, Size * Size);
+	Field.BuildNextStep.SetNumUninitialized(Size * Size);
+	Field.Frontier.Reset();
+	Field.FrontierHead = 0;
+	Field.BuildReferenceZ = TargetLocation.Z;
+	Field.bBuilding = true;
+	Field.bStale = false;
+
+	float GoalHeight;
+	if (GetCellHeight(Field.BuildGoalCell, Field.BuildReferenceZ, GoalHeight))
+	{
+		const int32 GoalIndex{ (Size / 2) * Size + Size / 2 };
+		Field.BuildSteps[GoalIndex] = 0;
+		Field.Frontier.Add(GoalIndex);
+	}
+}
+
+int32 UFlowFieldSubsystem::ContinueBuild(FFlowField& Field, int32 Budget)
+{
+	const int32 Size{ Field.BuildSize };
+	int32 Used{ 0 };
+
+	// Breadth first out from the goal; every step to a neighbour, diagonal or not, counts one
+	while (Field.FrontierHead < Field.Frontier.Num() && Used < Budget)
+	{
+		const int32 Index{ Field.Frontier[Field.FrontierHead++] };
+		const FIntPoint Local{ Index % Size, Index / Size };
+		const uint16 Steps{ Field.BuildSteps[Index] };
+		++Used;
+
+		float Height;
+		GetCellHeight(Field.BuildOrigin + Local, Field.BuildReferenceZ, Height);
+
+		for (int32 OffsetIndex = 0; OffsetIndex < UE_ARRAY_COUNT(NeighbourOffsets); OffsetIndex++)
+		{
+			const FIntPoint& Offset = NeighbourOffsets[OffsetIndex];
+			const FIntPoint Neighbour{ Local + Offset };
+			if (Neighbour.X < 0 || Neighbour.Y < 0 || Neighbour.X >= Size || Neighbour.Y >= Size) continue;
+
+			const int32 NeighbourIndex{ Neighbour.Y * Size + Neighbour.X };
+			if (Field.BuildSteps[NeighbourIndex] != UnreachedSteps) continue;
+
+			float NeighbourHeight;
+			if (!GetCellHeight(Field.BuildOrigin + Neighbour, Height, NeighbourHeight)) continue;
+			if (FMath::Abs(NeighbourHeight - Height) > MaxCellStepHeight) continue;
+
+			// No cutting corners past unwalkable cells
+			if (Offset.X != 0 && Offset.Y != 0)
+			{
+				float CornerHeight;
+				if (!GetCellHeight(Field.BuildOrigin + Local + FIntPoint(Offset.X, 0), Height, CornerHeight) ||
+					!GetCellHeight(Field.BuildOrigin + Local + FIntPoint(0, Offset.Y), Height, CornerHeight))
+				{
+					continue;
+				}
+			}
+
+			Field.BuildSteps[NeighbourIndex] = static_cast<uint16>(Steps + 1);
+			// The way back to Local
+			Field.BuildNextStep[NeighbourIndex] = static_cast<uint8>(OffsetIndex ^ 1);
+			Field.Frontier.Add(NeighbourIndex);
+		}
+	}
+	INC_DWORD_STAT_BY(STAT_FlowFieldCellsExpanded, Used);
+
+	if (Field.FrontierHead >= Field.Frontier.Num())
+	{
+		// Done; chasers switch to the new field
+		Field.Size = Field.BuildSize;
+		Field.Origin = Field.BuildOrigin;
+		Field.GoalCell = Field.BuildGoalCell;
+		Field.Steps = MoveTemp(Field.BuildSteps);
+		Field.NextStep = MoveTemp(Field.BuildNextStep);
+		Field.BuildSteps.Reset();
+		Field.BuildNextStep.Reset();
+		Field.Frontier.Reset();
+		Field.FrontierHead = 0;
+		Field.bBuilding = false;
+	}
+
+	return Used;
+}
+
+bool UFlowFieldSubsystem::GetCellHeight(const FIntPoint& Cell, float ReferenceZ, float& OutHeight)
+{
+	const float CellSize{ CVarFlowFieldCellSize.GetValueOnGameThread() };
+	if (CellSize != CachedCellSize)
+	{
+		CellHeights.Reset();
+		CachedCellSize = CellSize;
+	}
+
+	const float* CachedHeight = CellHeights.Find(Cell);
+	if (CachedHeight == nullptr)
+	{
+		INC_DWORD_STAT(STAT_FlowFieldProjections);
+
+		float Height{ UnwalkableHeight };
+		UNavigationSystemV1* NavSystem = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+		if (NavSystem && NavSystem != BoundNavSystem.Get())
+		{
+			// The navigation system is created after world subsystems, so bind on first use
+			NavSystem->OnNavigationGenerationFinishedDelegate.AddUniqueDynamic(this, &UFlowFieldSubsystem::OnNavigationGenerationFinished);
+			BoundNavSystem = NavSystem;
+		}
+		FNavLocation NavLocation;
+		const FVector CellCenter{ CellToWorld(Cell) + FVector(0.f, 0.f, ReferenceZ) };
+		if (NavSystem && NavSystem->ProjectPointToNavigation(
+			CellCenter,
+			NavLocation,
+			FVector(CellSize * 0.5f, CellSize * 0.5f, 250.f)))
+		{
+			Height = NavLocation.Location.Z;
+		}
+		CachedHeight = &CellHeights.Add(Cell, Height);
+		SET_DWORD_STAT(STAT_FlowFieldCachedHeights, CellHeights.Num());
+	}
+
+	OutHeight = *CachedHeight;
+	return OutHeight != UnwalkableHeight;
+}
+
+void UFlowFieldSubsystem::EvictUncoveredCells()
+{
+	TArray<FIntRect, TInlineAllocator<16>> Covered;
+	for (const FFlowField& Field : Fields)
+	{
+		if (Field.Steps.Num() > 0)
+		{
+			Covered.Emplace(Field.Origin, Field.Origin + FIntPoint(Field.Size, Field.Size));
+		}
+		if (Field.bBuilding)
+		{
+			Covered.Emplace(Field.BuildOrigin, Field.BuildOrigin + FIntPoint(Field.BuildSize, Field.BuildSize));
+		}
+	}
+
+	for (auto It = CellHeights.CreateIterator(); It; ++It)
+	{
+		const FIntPoint& Cell = It.Key();
+		const bool bCovered{ Covered.ContainsByPredicate([&Cell](const FIntRect& Rect)
+			{
+				return Cell.X >= Rect.Min.X && Cell.Y >= Rect.Min.Y && Cell.X < Rect.Max.X && Cell.Y < Rect.Max.Y;
+			}) };
+		if (!bCovered)
+		{
+			It.RemoveCurrent();
+		}
+	}
+	SET_DWORD_STAT(STAT_FlowFieldCachedHeights, CellHeights.Num());
+}
+
+void UFlowFieldSubsystem::OnNavigationGenerationFinished(ANavigationData* NavData)
+{
+	CellHeights.Reset();
+	SET_DWORD_STAT(STAT_FlowFieldCachedHeights, 0);
+
+	// Builds in progress started on the old heights; chasers keep the old field until the new one is done
+	for (FFlowField& Field : Fields)
+	{
+		Field.bBuilding = false;
+		Field.bStale = true;
+		Field.LastBuildStartTime = -1.f;
+	}
+}
+
+bool UFlowFieldSubsystem::IsTickable() const
+{
+	return Fields.Num() > 0 && !IsTemplate();
+}
+
+TStatId UFlowFieldSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UFlowFieldSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,115 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "FlowFieldSubsystem.generated.h"
+
+/** Result of sampling a flow field */
+enum class EFlowFieldSample : uint8
+{
+	/** OutDirection leads toward the target */
+	Direction,
+	/** The target's first field isn't finished yet */
+	Building,
+	/** Location is off the field or cut off from the target */
+	NoPath,
+};
+
+/**
+ * Flow fields toward chase targets, shared by every enemy chasing the same target.
+ * Each field is a grid centred on its target whose cells hold the step count to the
+ * target over the navmesh. It is rebuilt every update interval, a budgeted number of
+ * cells per frame, while chasers keep sampling the last finished field. A chaser's
+ * cost is one sample, however many others chase with it.
+ */
+UCLASS()
+class SHOOTER_API UFlowFieldSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	static UFlowFieldSubsystem* Get(const UObject* WorldContextObject);
+
+	/**
+	* Direction to walk from Location to reach Target, along the path the field was built over.
+	* Starts a field for Target if there isn't one
+	*/
+	EFlowFieldSample SampleDirection(AActor* Target, const FVector& Location, FVector& OutDirection);
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+private:
+	struct FFlowField
+	{
+		TWeakObjectPtr<AActor> Target;
+
+		/** Finished field, sampled by chasers. Size cells along X and Y */
+		int32 Size{ 0 };
+		FIntPoint Origin{ 0, 0 };
+		FIntPoint GoalCell{ 0, 0 };
+		TArray<uint16> Steps;
+		/** NeighbourOffsets index of the step from each reached cell toward the goal */
+		TArray<uint8> NextStep;
+
+		/** Field being built */
+		int32 BuildSize{ 0 };
+		FIntPoint BuildOrigin{ 0, 0 };
+		FIntPoint BuildGoalCell{ 0, 0 };
+		TArray<uint16> BuildSteps;
+		TArray<uint8> BuildNextStep;
+		TArray<int32> Frontier;
+		int32 FrontierHead{ 0 };
+		float BuildReferenceZ{ 0.f };
+		bool bBuilding{ false };
+
+		/** The navmesh changed since Steps was built; rebuild even if the target hasn't moved */
+		bool bStale{ false };
+
+		float LastBuildStartTime{ -1.f };
+		float LastSampledTime{ 0.f };
+	};
+
+	/** Cells each field spans along X and Y */
+	int32 GetFieldSize() const;
+
+	FIntPoint WorldToCell(const FVector& Location) const;
+	FVector CellToWorld(const FIntPoint& Cell) const;
+
+	void StartBuild(FFlowField& Field, const FVector& TargetLocation);
+
+	/** Expand up to Budget cells of Field's build; returns how many were used */
+	int32 ContinueBuild(FFlowField& Field, int32 Budget);
+
+	/** Navmesh height of Cell, projected once and cached; false if Cell has no navmesh */
+	bool GetCellHeight(const FIntPoint& Cell, float ReferenceZ, float& OutHeight);
+
+	/** Drop cached heights outside every field, finished or being built */
+	void EvictUncoveredCells();
+
+	/** Heights and fields built on the old navmesh are stale once it's rebuilt or an obstacle moves */
+	UFUNCTION()
+	void OnNavigationGenerationFinished(class ANavigationData* NavData);
+
+	TArray<FFlowField> Fields;
+
+	/**
+	* Navmesh heights by world cell, shared by every field. Unwalkable cells are stored too.
+	* Cleared when the navmesh is rebuilt; cells no field covers are evicted once it outgrows the fields
+	*/
+	TMap<FIntPoint, float> CellHeights;
+
+	/** Cell size CellHeights was filled with */
+	float CachedCellSize{ 0.f };
+
+	/** Navigation system OnNavigationGenerationFinished is bound on */
+	TWeakObjectPtr<class UNavigationSystemV1> BoundNavSystem;
+};
@@ -0,0 +1,188 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "InventoryComponent.h"
+#include "Item.h"
+
+UInventoryComponent::UInventoryComponent() :
+	Capacity(6),
+	FreeSlotMask(0),
+	BroadcastHighlightMask(0),
+	PendingHighlightMask(0),
+	bNoSlotHighlightPending(false),
+	bEquipPending(false),
+	PendingEquipFromSlot(-1),
+	PendingEquipToSlot(-1)
+{
+	bWantsInitializeComponent = true;
+
+	// Only ticks on frames with queued notifications
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.TickGroup = TG_PostUpdateWork;
+}
+
+void UInventoryComponent::InitializeComponent()
+{
+	Super::InitializeComponent();
+
+	Capacity = FMath::Clamp(Capacity, 1, MAX_CAPACITY);
+	Slots.SetNum(Capacity);
+	FreeSlotMask = Capacity == MAX_CAPACITY ? MAX_uint32 : (1u << Capacity) - 1u;
+}
+
+void UInventoryComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	FlushNotifications();
+	SetComponentTickEnabled(false);
+}
+
+FInventorySlotHandle UInventoryComponent::AddItem(AItem* Item, bool& bOutStacked)
+{
+	bOutStacked = false;
+	if (Item == nullptr) return FInventorySlotHandle();
+
+	// Try to merge into an existing stack of the same class
+	if (Item->GetMaxStackCount() > 1)
+	{
+		for (int32 i = 0; i < Slots.Num(); i++)
+		{
+			FInventorySlot& Slot{ Slots[i] };
+			if (Slot.Item &&
+				Slot.Item->GetClass() == Item->GetClass() &&
+				Slot.StackCount < Item->GetMaxStackCount())
+			{
+				++Slot.StackCount;
+				bOutStacked = true;
+				return FInventorySlotHandle{ i, Slot.Serial };
+			}
+		}
+	}
+
+	const int32 FreeSlot{ GetFirstFreeSlot() };
+	if (FreeSlot == -1) return FInventorySlotHandle(); // Inventory is full!
+
+	return SetItem(FreeSlot, Item);
+}
+
+FInventorySlotHandle UInventoryComponent::SetItem(int32 SlotIndex, AItem* Item)
+{
+	if (!IsValidSlot(SlotIndex)) return FInventorySlotHandle();
+
+	FInventorySlot& Slot{ Slots[SlotIndex] };
+	Slot.Item = Item;
+	Slot.StackCount = Item ? 1 : 0;
+	++Slot.Serial;
+
+	if (Item)
+	{
+		FreeSlotMask &= ~(1u << SlotIndex);
+	}
+	else
+	{
+		FreeSlotMask |= 1u << SlotIndex;
+	}
+
+	return FInventorySlotHandle{ SlotIndex, Slot.Serial };
+}
+
+void UInventoryComponent::RemoveItem(int32 SlotIndex)
+{
+	SetItem(SlotIndex, nullptr);
+}
+
+void UInventoryComponent::SetStackCount(int32 SlotIndex, int32 StackCount)
+{
+	if (!IsValidSlot(SlotIndex) || Slots[SlotIndex].Item == nullptr) return;
+
+	Slots[SlotIndex].StackCount = FMath::Max(StackCount, 1);
+}
+
+AItem* UInventoryComponent::ResolveHandle(const FInventorySlotHandle& Handle) const
+{
+	if (!IsValidSlot(Handle.Index)) return nullptr;
+
+	const FInventorySlot& Slot{ Slots[Handle.Index] };
+	return Slot.Serial == Handle.Serial ? Slot.Item : nullptr;
+}
+
+AItem* UInventoryComponent::GetItem(int32 SlotIndex) const
+{
+	return IsValidSlot(SlotIndex) ? Slots[SlotIndex].Item : nullptr;
+}
+
+int32 UInventoryComponent::GetStackCount(int32 SlotIndex) const
+{
+	return IsValidSlot(SlotIndex) ? Slots[SlotIndex].StackCount : 0;
+}
+
+int32 UInventoryComponent::GetFirstFreeSlot() const
+{
+	if (FreeSlotMask == 0) return -1;
+
+	return static_cast<int32>(FMath::CountTrailingZeros(FreeSlotMask));
+}
+
+void UInventoryComponent::QueueEquipNotify(int32 CurrentSlotIndex, int32 NewSlotIndex)
+{
+	if (!bEquipPending)
+	{
+		// Keep the slot we started the frame on
+		PendingEquipFromSlot = CurrentSlotIndex;
+		bEquipPending = true;
+	}
+	PendingEquipToSlot = NewSlotIndex;
+	SetComponentTickEnabled(true);
+}
+
+void UInventoryComponent::QueueHighlightNotify(int32 SlotIndex, bool bHighlight)
+{
+	if (SlotIndex == -1 && bHighlight)
+	{
+		bNoSlotHighlightPending = true;
+		SetComponentTickEnabled(true);
+		return;
+	}
+	if (!IsValidSlot(SlotIndex)) return;
+
+	if (bHighlight)
+	{
+		PendingHighlightMask |= 1u << SlotIndex;
+	}
+	else
+	{
+		PendingHighlightMask &= ~(1u << SlotIndex);
+	}
+	SetComponentTickEnabled(true);
+}
+
+void UInventoryComponent::FlushNotifications()
+{
+	if (bEquipPending)
+	{
+		bEquipPending = false;
+		// -1 == nothing was equipped; always announce the first equip
+		if (PendingEquipFromSlot != PendingEquipToSlot || PendingEquipFromSlot == -1)
+		{
+			EquipItemDelegate.Broadcast(PendingEquipFromSlot, PendingEquipToSlot);
+		}
+	}
+
+	// Only slots whose highlight differs from the last broadcast
+	uint32 ChangedSlots{ PendingHighlightMask ^ BroadcastHighlightMask };
+	BroadcastHighlightMask = PendingHighlightMask;
+	while (ChangedSlots != 0)
+	{
+		const int32 SlotIndex{ static_cast<int32>(FMath::CountTrailingZeros(ChangedSlots)) };
+		ChangedSlots &= ChangedSlots - 1u;
+		HighlightIconDelegate.Broadcast(SlotIndex, (PendingHighlightMask & (1u << SlotIndex)) != 0);
+	}
+
+	if (bNoSlotHighlightPending)
+	{
+		bNoSlotHighlightPending = false;
+		HighlightIconDelegate.Broadcast(-1, true);
+	}
+}
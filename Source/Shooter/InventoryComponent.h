@@ -0,0 +1,144 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "InventoryComponent.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FEquipItemDelegate, int32, CurrentSlotIndex, int32, NewSlotIndex);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FHighlightIconDelegate, int32, SlotIndex, bool, bStartAnimation);
+
+/** Refers to one occupant of an inventory slot; goes stale when the slot's item changes */
+USTRUCT(BlueprintType)
+struct FInventorySlotHandle
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 Index = INDEX_NONE;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 Serial = 0;
+
+	bool IsValid() const { return Index != INDEX_NONE; }
+};
+
+USTRUCT(BlueprintType)
+struct FInventorySlot
+{
+	GENERATED_BODY()
+
+	// Item stored in this slot; null when the slot is free
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	class AItem* Item = nullptr;
+
+	// Number of items stacked in this slot
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 StackCount = 0;
+
+	// Bumped every time the slot's item changes
+	int32 Serial = 0;
+};
+
+/**
+ * Fixed capacity item storage with a free slot bitmask.
+ * Slot change notifications are coalesced and broadcast once per frame.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class SHOOTER_API UInventoryComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UInventoryComponent();
+
+	/** Upper bound for Capacity; one bit per slot in the free slot mask */
+	static constexpr int32 MAX_CAPACITY{ 32 };
+
+	virtual void InitializeComponent() override;
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	/**
+	* Add Item onto a matching stack or into the first free slot
+	* @param bOutStacked  True if Item was merged into an existing stack and can be destroyed
+	* @return Handle to the slot holding Item; invalid if the inventory is full
+	*/
+	FInventorySlotHandle AddItem(AItem* Item, bool& bOutStacked);
+
+	/** Put Item into SlotIndex, replacing whatever was there */
+	FInventorySlotHandle SetItem(int32 SlotIndex, AItem* Item);
+
+	/** Empty SlotIndex */
+	void RemoveItem(int32 SlotIndex);
+
+	/** Set the stack size of an occupied slot, at least 1 */
+	void SetStackCount(int32 SlotIndex, int32 StackCount);
+
+	/** Item for Handle, or null if the slot has changed since the handle was made */
+	AItem* ResolveHandle(const FInventorySlotHandle& Handle) const;
+
+	UFUNCTION(BlueprintPure, Category = Inventory)
+	AItem* GetItem(int32 SlotIndex) const;
+
+	UFUNCTION(BlueprintPure, Category = Inventory)
+	int32 GetStackCount(int32 SlotIndex) const;
+
+	/** Lowest free slot, or -1 if the inventory is full */
+	UFUNCTION(BlueprintPure, Category = Inventory)
+	int32 GetFirstFreeSlot() const;
+
+	UFUNCTION(BlueprintPure, Category = Inventory)
+	bool IsFull() const { return FreeSlotMask == 0; }
+
+	/** Queue an equip notification; only the net change this frame is broadcast */
+	void QueueEquipNotify(int32 CurrentSlotIndex, int32 NewSlotIndex);
+
+	/**
+	* Queue a slot highlight change; only the net change this frame is broadcast.
+	* Highlighting slot -1 (no free slot) is passed on as is, at most once per frame
+	*/
+	void QueueHighlightNotify(int32 SlotIndex, bool bHighlight);
+
+	/** Broadcast when the equipped slot changes */
+	UPROPERTY(BlueprintAssignable, Category = Delegates)
+	FEquipItemDelegate EquipItemDelegate;
+
+	/** Broadcast when a slot starts or stops being highlighted */
+	UPROPERTY(BlueprintAssignable, Category = Delegates)
+	FHighlightIconDelegate HighlightIconDelegate;
+
+private:
+	bool IsValidSlot(int32 SlotIndex) const { return SlotIndex >= 0 && SlotIndex < Slots.Num(); }
+
+	/** Broadcast the notifications queued this frame */
+	void FlushNotifications();
+
+	/** Number of slots */
+	UPROPERTY(EditDefaultsOnly, Category = Inventory, meta = (AllowPrivateAccess = "true", ClampMin = "1", ClampMax = "32"))
+	int32 Capacity;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Inventory, meta = (AllowPrivateAccess = "true"))
+	TArray<FInventorySlot> Slots;
+
+	/** One bit per slot; set when the slot is free */
+	uint32 FreeSlotMask;
+
+	/** Slots highlighted as of the last broadcast */
+	uint32 BroadcastHighlightMask;
+
+	/** Slots that should be highlighted at the next broadcast */
+	uint32 PendingHighlightMask;
+
+	/** Slot -1 was highlighted this frame; the HUD clears its highlight on it */
+	bool bNoSlotHighlightPending;
+
+	/** Queued equip notification */
+	bool bEquipPending;
+	int32 PendingEquipFromSlot;
+	int32 PendingEquipToSlot;
+
+public:
+	FORCEINLINE int32 GetCapacity() const { return Capacity; }
+};
@@ -10,6 +10,13 @@
 #include "Kismet/GameplayStatics.h"
 #include "Sound/SoundCue.h"
 #include "Curves/CurveVector.h"
+#include "Engine/CollisionProfile.h"
+#include "Shooter.h"
+#include "WorldSnapshot.h"
+#include "ShooterMemory.h"
+
+DECLARE_CYCLE_STAT(TEXT("Item SetItemState"), STAT_ItemSetItemState, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Item State Transitions"), STAT_ItemStateTransitions, STATGROUP_Shooter);
 
 // Sets default values
 AItem::AItem() :
@@ -35,8 +42,11 @@ AItem::AItem() :
 	FresnelReflectFraction(4.f),
 	PulseCurveTime(5.f),
 	SlotIndex(0),
+	MaxStackCount(1),
 	bCharacterInventoryFull(false)
 {
+	SHOOTER_LLM_SCOPE(Items);
+
 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
 
@@ -45,10 +55,7 @@ AItem::AItem() :
 
 	CollisionBox = CreateDefaultSubobject<UBoxComponent>(TEXT("CollisionBox"));
 	CollisionBox->SetupAttachment(ItemMesh);
-	CollisionBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-	CollisionBox->SetCollisionResponseToChannel(
-		ECollisionChannel::ECC_Visibility,
-		ECollisionResponse::ECR_Block);
+	CollisionBox->SetCollisionProfileName(TEXT("ItemPickupBox"));
 
 	PickupWidget = CreateDefaultSubobject<UWidgetComponent>(TEXT("PickupWidget"));
 	PickupWidget->SetupAttachment(GetRootComponent());
@@ -60,6 +67,7 @@ AItem::AItem() :
 // Called when the game starts or when spawned
 void AItem::BeginPlay()
 {
+	SHOOTER_LLM_SCOPE(Items);
 	Super::BeginPlay();
 
 	ID = FGuid::NewGuid();
@@ -150,86 +158,62 @@ void AItem::SetActiveStars()
 
 void AItem::SetItemProperties(EItemState State)
 {
-	switch (State)
+	const FItemStateProfile& Profile{ GetItemStateProfile(State) };
+
+	if (Profile.bHidePickupWidget)
 	{
-	case EItemState::EIS_Pickup:
-		// Set mesh properties
-		ItemMesh->SetSimulatePhysics(false);
-		ItemMesh->SetEnableGravity(false);
-		ItemMesh->SetVisibility(true);
-		ItemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		ItemMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		// Set AreaSphere properties
-		AreaSphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Overlap);
-		AreaSphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
-		// Set CollisionBox properties
-		CollisionBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		CollisionBox->SetCollisionResponseToChannel(
-			ECollisionChannel::ECC_Visibility,
-			ECollisionResponse::ECR_Block);
-		CollisionBox->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
-		break;
-	case EItemState::EIS_Equipped:
-		// Set mesh properties
-		ItemMesh->SetSimulatePhysics(false);
-		ItemMesh->SetEnableGravity(false);
-		ItemMesh->SetVisibility(true);
-		ItemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		ItemMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		// Set AreaSphere properties
-		AreaSphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		AreaSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		// Set CollisionBox properties
-		CollisionBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		CollisionBox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		break;
-	case EItemState::EIS_Falling:
-		// Set mesh properties
-		ItemMesh->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
-		ItemMesh->SetSimulatePhysics(true);
-		ItemMesh->SetEnableGravity(true);
-		ItemMesh->SetVisibility(true);
-		ItemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		ItemMesh->SetCollisionResponseToChannel(
-			ECollisionChannel::ECC_WorldStatic,
-			ECollisionResponse::ECR_Block);
-		// Set AreaSphere properties
-		AreaSphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		AreaSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		// Set CollisionBox properties
-		CollisionBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		CollisionBox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		break;
-	case EItemState::EIS_EquipInterping:
-		PickupWidget->SetVisibility(false);
-		// Set mesh properties
-		ItemMesh->SetSimulatePhysics(false);
-		ItemMesh->SetEnableGravity(false);
-		ItemMesh->SetVisibility(true);
-		ItemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		ItemMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		// Set AreaSphere properties
-		AreaSphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		AreaSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		// Set CollisionBox properties
-		CollisionBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		CollisionBox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		break;
-	case EItemState::EIS_PickedUp:
 		PickupWidget->SetVisibility(false);
-		// Set mesh properties
-		ItemMesh->SetSimulatePhysics(false);
-		ItemMesh->SetEnableGravity(false);
-		ItemMesh->SetVisibility(false);
-		ItemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		ItemMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		// Set AreaSphere properties
-		AreaSphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		AreaSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		// Set CollisionBox properties
-		CollisionBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		CollisionBox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		break;
+	}
+	// Set mesh properties
+	SetCollisionProfile(ItemMesh, Profile.MeshProfile);
+	SetPhysicsState(ItemMesh, Profile.bSimulatePhysics);
+	ItemMesh->SetVisibility(Profile.bMeshVisible);
+	// Set AreaSphere properties
+	SetCollisionProfile(AreaSphere, Profile.AreaSphereProfile);
+	// Set CollisionBox properties
+	SetCollisionProfile(CollisionBox, Profile.CollisionBoxProfile);
+}
+
+const FItemStateProfile& AItem::GetItemStateProfile(EItemState State)
+{
+	// Mesh, AreaSphere and CollisionBox profiles, simulate physics, mesh visible, hide widget
+	static const FItemStateProfile Profiles[] =
+	{
+		// EIS_Pickup
+		{ UCollisionProfile::NoCollision_ProfileName, TEXT("ItemAreaSphere"), TEXT("ItemPickupBox"), false, true, false },
+		// EIS_EquipInterping
+		{ UCollisionProfile::NoCollision_ProfileName, UCollisionProfile::NoCollision_ProfileName, UCollisionProfile::NoCollision_ProfileName, false, true, true },
+		// EIS_PickedUp
+		{ UCollisionProfile::NoCollision_ProfileName, UCollisionProfile::NoCollision_ProfileName, UCollisionProfile::NoCollision_ProfileName, false, false, true },
+		// EIS_Equipped
+		{ UCollisionProfile::NoCollision_ProfileName, UCollisionProfile::NoCollision_ProfileName, UCollisionProfile::NoCollision_ProfileName, false, true, false },
+		// EIS_Falling
+		{ TEXT("ItemFallingMesh"), UCollisionProfile::NoCollision_ProfileName, UCollisionProfile::NoCollision_ProfileName, true, true, false },
+	};
+	static_assert(UE_ARRAY_COUNT(Profiles) == static_cast<int32>(EItemState::EIS_MAX), "One profile per EItemState");
+
+	check(State < EItemState::EIS_MAX);
+	return Profiles[static_cast<int32>(State)];
+}
+
+void AItem::SetCollisionProfile(UPrimitiveComponent* Component, FName ProfileName)
+{
+	// Each profile switch recreates physics state and updates overlaps; skip redundant ones
+	if (Component->GetCollisionProfileName() != ProfileName)
+	{
+		Component->SetCollisionProfileName(ProfileName);
+	}
+}
+
+void AItem::SetPhysicsState(UPrimitiveComponent* Component, bool bSimulate)
+{
+	if (Component->IsSimulatingPhysics() != bSimulate)
+	{
+		Component->SetSimulatePhysics(bSimulate);
+	}
+	if (Component->IsGravityEnabled() != bSimulate)
+	{
+		Component->SetEnableGravity(bSimulate);
 	}
 }
 
@@ -372,6 +356,8 @@ void AItem::InitializeCustomDepth()
 
 void AItem::OnConstruction(const FTransform& Transform)
 {
+	SHOOTER_LLM_SCOPE(Items);
+
 	// Load the data in the Item Rarity Data Table
 
 	// Path to the Item Rarity Data Table
@@ -515,10 +501,56 @@ void AItem::StartPulseTimer()
 
 void AItem::SetItemState(EItemState State)
 {
+	SCOPE_CYCLE_COUNTER(STAT_ItemSetItemState);
+	INC_DWORD_STAT(STAT_ItemStateTransitions);
+
 	ItemState = State;
 	SetItemProperties(State);
 }
 
+void AItem::CaptureSnapshot(FItemSnapshot& Snapshot) const
+{
+	Snapshot.ItemRarity = static_cast<uint8>(ItemRarity);
+	Snapshot.ItemCount = ItemCount;
+
+	switch (ItemState)
+	{
+	case EItemState::EIS_EquipInterping:
+		// Still on its way to the Character: put it back where it was picked up from
+		Snapshot.Actor.Location = ItemInterpStartLocation;
+		Snapshot.ItemState = static_cast<uint8>(EItemState::EIS_Pickup);
+		break;
+	case EItemState::EIS_Falling:
+		Snapshot.ItemState = static_cast<uint8>(EItemState::EIS_Pickup);
+		break;
+	default:
+		Snapshot.ItemState = static_cast<uint8>(ItemState);
+		break;
+	}
+}
+
+void AItem::RestoreSnapshot(const FItemSnapshot& Snapshot)
+{
+	if (bInterping)
+	{
+		// Stop the pickup so FinishInterping doesn't hand us to the Character
+		GetWorldTimerManager().ClearTimer(ItemInterpTimer);
+		bInterping = false;
+		if (Character)
+		{
+			Character->IncrementInterpLocItemCount(InterpLocIndex, -1);
+		}
+		SetActorScale3D(FVector(1.f));
+		bCanChangeCustomDepth = true;
+	}
+
+	ItemCount = Snapshot.ItemCount;
+	const EItemState State{ Snapshot.ItemState < static_cast<uint8>(EItemState::EIS_MAX) ?
+		static_cast<EItemState>(Snapshot.ItemState) :
+		EItemState::EIS_Pickup };
+	SetItemState(State);
+}
+
 void AItem::StartItemCurve(AShooterCharacter* Char, bool bForcePlaySound)
 {
 	// Store a handle to the Character
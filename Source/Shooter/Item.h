@@ -40,6 +40,17 @@ enum class EItemType : uint8
 	EIT_MAX UMETA(DisplayName = "DefaultMAX")
 };
 
+/** Collision profiles and physics settings for an Item's components in one EItemState */
+struct FItemStateProfile
+{
+	FName MeshProfile;
+	FName AreaSphereProfile;
+	FName CollisionBoxProfile;
+	bool bSimulatePhysics;
+	bool bMeshVisible;
+	bool bHidePickupWidget;
+};
+
 USTRUCT(BlueprintType)
 struct FItemRarityTable : public FTableRowBase
 {
@@ -101,6 +112,12 @@ protected:
 	/** Sets properties of the Item's components based on State */
 	virtual void SetItemProperties(EItemState State);
 
+	/** Switch Component to ProfileName if it isn't using it already */
+	static void SetCollisionProfile(UPrimitiveComponent* Component, FName ProfileName);
+
+	/** Set physics simulation and gravity, only touching what changed */
+	static void SetPhysicsState(UPrimitiveComponent* Component, bool bSimulate);
+
 	/** Called when ItemInterpTimer is finished */
 	void FinishInterping();
 
@@ -129,6 +146,9 @@ public:
 	// Called in AShooterCharacter::GetPickupItem
 	void PlayEquipSound(bool bForcePlaySound = false);
 
+	/** Collision and physics settings used for each EItemState */
+	static const FItemStateProfile& GetItemStateProfile(EItemState State);
+
 private:
 	/** Skeletal Mesh for the item */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
@@ -265,6 +285,10 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Inventory, meta = (AllowPrivateAccess = "true"))
 	int32 SlotIndex;
 
+	/** Number of these items that fit in one inventory slot */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Inventory, meta = (AllowPrivateAccess = "true", ClampMin = "1"))
+	int32 MaxStackCount;
+
 	/** True when the Character's inventory is full */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Inventory, meta = (AllowPrivateAccess = "true"))
 	bool bCharacterInventoryFull;
@@ -310,13 +334,16 @@ public:
 	FORCEINLINE int32 GetItemCount() const { return ItemCount; }
 	FORCEINLINE int32 GetSlotIndex() const { return SlotIndex; }
 	FORCEINLINE void SetSlotIndex(int32 Index) { SlotIndex = Index; }
+	FORCEINLINE int32 GetMaxStackCount() const { return MaxStackCount; }
 	FORCEINLINE void SetCharacter(AShooterCharacter* Char) { Character = Char; }
 	FORCEINLINE void SetCharacterInventoryFull(bool bFull) { bCharacterInventoryFull = bFull; }
+	FORCEINLINE const FString& GetItemName() const { return ItemName; }
 	FORCEINLINE void SetItemName(FString Name) { ItemName = Name; }
 	// Set item icon for the inventory
 	FORCEINLINE void SetIconItem(UTexture2D* Icon) { IconItem = Icon; }
 	// Set ammo icon for the pickup widget
 	FORCEINLINE void SetAmmoIcon(UTexture2D* Icon) { AmmoItem = Icon; }
+	FORCEINLINE UTexture2D* GetAmmoIcon() const { return AmmoItem; }
 	FORCEINLINE void SetMaterialInstance(UMaterialInstance* Instance) { MaterialInstance = Instance; }
 	FORCEINLINE UMaterialInstance* GetMaterialInstance() const { return MaterialInstance; }
 	FORCEINLINE void SetDynamicMaterialInstance(UMaterialInstanceDynamic* Instance) { DynamicMaterialInstance = Instance; }
@@ -328,6 +355,15 @@ public:
 	/** Called from the AShooterCharacter class */
 	void StartItemCurve(AShooterCharacter* Char, bool bForcePlaySound = false);
 
+	/** Save state, count and rarity; the actor part of Snapshot is filled in by the caller */
+	virtual void CaptureSnapshot(struct FItemSnapshot& Snapshot) const;
+
+	/** Return to a saved state, abandoning a pickup in progress */
+	virtual void RestoreSnapshot(const struct FItemSnapshot& Snapshot);
+
+	/** Rarity is applied in OnConstruction, so only set it before the Item finishes spawning */
+	FORCEINLINE void SetItemRarity(EItemRarity Rarity) { ItemRarity = Rarity; }
+
 	virtual void EnableCustomDepth();
 	virtual void DisableCustomDepth();
 	void DisableGlowMaterial();
@@ -0,0 +1,211 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+#include "Engine/Engine.h"
+#include "Components/BoxComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Components/SphereComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Components/WidgetComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Item.h"
+#include "Shooter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	/** Channels items responded to before the Interactable and Weapon trace channels existed */
+	const ECollisionChannel ParityChannels[] =
+	{
+		ECC_WorldStatic, ECC_WorldDynamic, ECC_Pawn, ECC_Visibility,
+		ECC_Camera, ECC_PhysicsBody, ECC_Vehicle, ECC_Destructible,
+	};
+
+	void TestSameCollision(FAutomationTestBase& Test, const FString& What, const UPrimitiveComponent* Legacy, const UPrimitiveComponent* Profiled)
+	{
+		Test.TestEqual(What + TEXT(" collision enabled"),
+			static_cast<int32>(Profiled->GetCollisionEnabled()),
+			static_cast<int32>(Legacy->GetCollisionEnabled()));
+		for (const ECollisionChannel Channel : ParityChannels)
+		{
+			Test.TestEqual(FString::Printf(TEXT("%s response to %s"), *What, *UEnum::GetValueAsString(Channel)),
+				static_cast<int32>(Profiled->GetCollisionResponseToChannel(Channel)),
+				static_cast<int32>(Legacy->GetCollisionResponseToChannel(Channel)));
+		}
+	}
+
+	/** ItemMesh and AmmoMesh setter calls from before the collision profiles */
+	void ApplyLegacyMesh(UPrimitiveComponent* Mesh, EItemState State)
+	{
+		Mesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
+		if (State == EItemState::EIS_Falling)
+		{
+			Mesh->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+			Mesh->SetCollisionResponseToChannel(ECollisionChannel::ECC_WorldStatic, ECollisionResponse::ECR_Block);
+		}
+		else
+		{
+			Mesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		}
+	}
+
+	void ApplyLegacyAreaSphere(UPrimitiveComponent* AreaSphere, EItemState State)
+	{
+		const bool bPickup{ State == EItemState::EIS_Pickup };
+		AreaSphere->SetCollisionResponseToAllChannels(bPickup ? ECollisionResponse::ECR_Overlap : ECollisionResponse::ECR_Ignore);
+		AreaSphere->SetCollisionEnabled(bPickup ? ECollisionEnabled::QueryOnly : ECollisionEnabled::NoCollision);
+	}
+
+	void ApplyLegacyCollisionBox(UPrimitiveComponent* CollisionBox, EItemState State)
+	{
+		CollisionBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
+		CollisionBox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		if (State == EItemState::EIS_Pickup)
+		{
+			// The pickup trace used to block Visibility; it has its own Interactable channel now and only needs queries
+			CollisionBox->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+		}
+	}
+
+	/** AItem::SetItemProperties from before the collision profiles: every setter, every transition */
+	void ApplyLegacyItemState(AItem* Item, EItemState State)
+	{
+		if (State == EItemState::EIS_EquipInterping || State == EItemState::EIS_PickedUp)
+		{
+			Item->GetPickupWidget()->SetVisibility(false);
+		}
+		USkeletalMeshComponent* ItemMesh = Item->GetItemMesh();
+		const bool bFalling{ State == EItemState::EIS_Falling };
+		ItemMesh->SetSimulatePhysics(bFalling);
+		ItemMesh->SetEnableGravity(bFalling);
+		ItemMesh->SetVisibility(State != EItemState::EIS_PickedUp);
+		ApplyLegacyMesh(ItemMesh, State);
+		ApplyLegacyAreaSphere(Item->GetAreaSphere(), State);
+		ApplyLegacyCollisionBox(Item->GetCollisionBox(), State);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FItemCollisionProfileParityTest, "Shooter.Item.CollisionProfilesMatchLegacySetters",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FItemCollisionProfileParityTest::RunTest(const FString& Parameters)
+{
+	for (int32 StateIndex = 0; StateIndex < static_cast<int32>(EItemState::EIS_MAX); StateIndex++)
+	{
+		const EItemState State{ static_cast<EItemState>(StateIndex) };
+		const FString StateName{ UEnum::GetValueAsString(State) };
+		const FItemStateProfile& Profile{ AItem::GetItemStateProfile(State) };
+
+		UStaticMeshComponent* LegacyMesh = NewObject<UStaticMeshComponent>();
+		UStaticMeshComponent* ProfiledMesh = NewObject<UStaticMeshComponent>();
+		ApplyLegacyMesh(LegacyMesh, State);
+		ProfiledMesh->SetCollisionProfileName(Profile.MeshProfile);
+		TestSameCollision(*this, StateName + TEXT(" ItemMesh"), LegacyMesh, ProfiledMesh);
+
+		USphereComponent* LegacySphere = NewObject<USphereComponent>();
+		USphereComponent* ProfiledSphere = NewObject<USphereComponent>();
+		ApplyLegacyAreaSphere(LegacySphere, State);
+		ProfiledSphere->SetCollisionProfileName(Profile.AreaSphereProfile);
+		TestSameCollision(*this, StateName + TEXT(" AreaSphere"), LegacySphere, ProfiledSphere);
+
+		UBoxComponent* LegacyBox = NewObject<UBoxComponent>();
+		UBoxComponent* ProfiledBox = NewObject<UBoxComponent>();
+		ApplyLegacyCollisionBox(LegacyBox, State);
+		ProfiledBox->SetCollisionProfileName(Profile.CollisionBoxProfile);
+		TestSameCollision(*this, StateName + TEXT(" CollisionBox"), LegacyBox, ProfiledBox);
+		TestEqual(StateName + TEXT(" CollisionBox response to Interactable"),
+			static_cast<int32>(ProfiledBox->GetCollisionResponseToChannel(ECC_Interactable)),
+			static_cast<int32>(State == EItemState::EIS_Pickup ? ECollisionResponse::ECR_Block : ECollisionResponse::ECR_Ignore));
+
+		// Same profile choice as AAmmo::SetItemProperties
+		UStaticMeshComponent* LegacyAmmoMesh = NewObject<UStaticMeshComponent>();
+		UStaticMeshComponent* ProfiledAmmoMesh = NewObject<UStaticMeshComponent>();
+		ApplyLegacyMesh(LegacyAmmoMesh, State);
+		ProfiledAmmoMesh->SetCollisionProfileName(
+			State == EItemState::EIS_Falling ? FName(TEXT("AmmoFallingMesh")) : UCollisionProfile::NoCollision_ProfileName);
+		TestSameCollision(*this, StateName + TEXT(" AmmoMesh"), LegacyAmmoMesh, ProfiledAmmoMesh);
+
+		TestEqual(StateName + TEXT(" simulates physics"), Profile.bSimulatePhysics, State == EItemState::EIS_Falling);
+		TestEqual(StateName + TEXT(" mesh visible"), Profile.bMeshVisible, State != EItemState::EIS_PickedUp);
+	}
+
+	// A missing profile falls back to the engine default instead of failing, so check they all loaded
+	FCollisionResponseTemplate Template;
+	for (const TCHAR* ProfileName : { TEXT("ItemPickupBox"), TEXT("ItemAreaSphere"), TEXT("ItemFallingMesh"), TEXT("AmmoFallingMesh") })
+	{
+		TestTrue(FString::Printf(TEXT("Collision profile %s exists"), ProfileName),
+			UCollisionProfile::Get()->GetProfileTemplate(FName(ProfileName), Template));
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FItemStateTransitionBenchmark, "Shooter.Item.StateTransitionBenchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FItemStateTransitionBenchmark::RunTest(const FString& Parameters)
+{
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	// Registered components, so every collision change recreates physics state and updates overlaps as in game
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	AItem* Item = World->SpawnActor<AItem>(AItem::StaticClass(), FTransform::Identity, SpawnParams);
+	if (Item == nullptr)
+	{
+		AddError(TEXT("Could not spawn an item to benchmark"));
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+		return false;
+	}
+
+	// The order an item goes through in play: picked up, held, swapped out and dropped
+	const EItemState Cycle[] =
+	{
+		EItemState::EIS_Pickup, EItemState::EIS_EquipInterping, EItemState::EIS_PickedUp,
+		EItemState::EIS_Equipped, EItemState::EIS_Falling,
+	};
+	constexpr int32 CyclesPerPass{ 2000 };
+	constexpr int32 Passes{ 5 };
+	double LegacySeconds{ TNumericLimits<double>::Max() };
+	double ProfileSeconds{ TNumericLimits<double>::Max() };
+	for (int32 Pass = 0; Pass < Passes; Pass++)
+	{
+		double PassStart{ FPlatformTime::Seconds() };
+		for (int32 CycleIndex = 0; CycleIndex < CyclesPerPass; CycleIndex++)
+		{
+			for (const EItemState State : Cycle)
+			{
+				ApplyLegacyItemState(Item, State);
+			}
+		}
+		LegacySeconds = FMath::Min(LegacySeconds, FPlatformTime::Seconds() - PassStart);
+
+		PassStart = FPlatformTime::Seconds();
+		for (int32 CycleIndex = 0; CycleIndex < CyclesPerPass; CycleIndex++)
+		{
+			for (const EItemState State : Cycle)
+			{
+				Item->SetItemState(State);
+			}
+		}
+		ProfileSeconds = FMath::Min(ProfileSeconds, FPlatformTime::Seconds() - PassStart);
+	}
+
+	const double NumTransitions{ static_cast<double>(CyclesPerPass * UE_ARRAY_COUNT(Cycle)) };
+	AddInfo(FString::Printf(TEXT("%.0f state transitions per pass, best of %d passes"), NumTransitions, Passes));
+	AddInfo(FString::Printf(TEXT("Legacy setters: %.2f us per transition"), LegacySeconds * 1e6 / NumTransitions));
+	AddInfo(FString::Printf(TEXT("Collision profiles: %.2f us per transition"), ProfileSeconds * 1e6 / NumTransitions));
+	AddInfo(FString::Printf(TEXT("Collision profiles take %.2fx the time of the legacy setters"),
+		ProfileSeconds / FMath::Max(LegacySeconds, SMALL_NUMBER)));
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	return true;
+}
+
+#endif
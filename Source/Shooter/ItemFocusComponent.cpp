@@ -0,0 +1,142 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ItemFocusComponent.h"
+#include "Item.h"
+#include "Components/WidgetComponent.h"
+#include "Shooter.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Item Focus Updates Avoided"), STAT_ItemFocusUpdatesAvoided, STATGROUP_Shooter);
+
+UItemFocusComponent::UItemFocusComponent() :
+	FocusedItem(nullptr),
+	CandidateItem(nullptr),
+	CandidateTime(0.f),
+	MissedTime(0.f),
+	FocusSwitchDelay(0.05f),
+	FocusLossDelay(0.1f),
+	bPickupWidgetShown(false),
+	bInventoryFull(false),
+	bInventoryFullPushed(false)
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+bool UItemFocusComponent::UpdateFocus(AItem* HitItem, float DeltaTime)
+{
+	// Items that are being picked up or equipped can't keep focus
+	if (FocusedItem && (!IsValid(FocusedItem) || FocusedItem->GetItemState() != EItemState::EIS_Pickup))
+	{
+		ClearFocus();
+	}
+
+	if (HitItem == FocusedItem)
+	{
+		MissedTime = 0.f;
+		CandidateItem = nullptr;
+		CandidateTime = 0.f;
+		// Custom depth stays as it is; nothing was skipped if nothing is focused
+		if (FocusedItem)
+		{
+			INC_DWORD_STAT(STAT_ItemFocusUpdatesAvoided);
+		}
+		return false;
+	}
+
+	if (HitItem == nullptr)
+	{
+		// Keep focus briefly so jitter at the edge of an item doesn't flicker
+		CandidateItem = nullptr;
+		CandidateTime = 0.f;
+		MissedTime += DeltaTime;
+		if (MissedTime < FocusLossDelay)
+		{
+			INC_DWORD_STAT(STAT_ItemFocusUpdatesAvoided);
+			return false;
+		}
+		UnfocusItem();
+		return true;
+	}
+
+	if (FocusedItem == nullptr)
+	{
+		FocusItem(HitItem);
+		return true;
+	}
+
+	// A different item is under the crosshairs; wait until it has been there long enough
+	if (HitItem != CandidateItem)
+	{
+		CandidateItem = HitItem;
+		CandidateTime = 0.f;
+	}
+	CandidateTime += DeltaTime;
+	if (CandidateTime < FocusSwitchDelay)
+	{
+		INC_DWORD_STAT(STAT_ItemFocusUpdatesAvoided);
+		return false;
+	}
+
+	UnfocusItem();
+	FocusItem(HitItem);
+	return true;
+}
+
+void UItemFocusComponent::SetShowPickupWidget(bool bShow)
+{
+	if (FocusedItem == nullptr) return;
+
+	if (bPickupWidgetShown == bShow)
+	{
+		INC_DWORD_STAT(STAT_ItemFocusUpdatesAvoided);
+		return;
+	}
+	bPickupWidgetShown = bShow;
+	FocusedItem->GetPickupWidget()->SetVisibility(bShow);
+}
+
+void UItemFocusComponent::SetInventoryFull(bool bFull)
+{
+	if (FocusedItem == nullptr) return;
+
+	if (bInventoryFullPushed && bInventoryFull == bFull)
+	{
+		INC_DWORD_STAT(STAT_ItemFocusUpdatesAvoided);
+		return;
+	}
+	bInventoryFull = bFull;
+	bInventoryFullPushed = true;
+	FocusedItem->SetCharacterInventoryFull(bFull);
+}
+
+void UItemFocusComponent::ClearFocus()
+{
+	CandidateItem = nullptr;
+	CandidateTime = 0.f;
+	UnfocusItem();
+}
+
+void UItemFocusComponent::FocusItem(AItem* Item)
+{
+	FocusedItem = Item;
+	MissedTime = 0.f;
+	CandidateItem = nullptr;
+	CandidateTime = 0.f;
+	bPickupWidgetShown = false;
+	bInventoryFullPushed = false;
+
+	FocusedItem->EnableCustomDepth();
+}
+
+void UItemFocusComponent::UnfocusItem()
+{
+	if (IsValid(FocusedItem))
+	{
+		FocusedItem->GetPickupWidget()->SetVisibility(false);
+		FocusedItem->DisableCustomDepth();
+	}
+	FocusedItem = nullptr;
+	MissedTime = 0.f;
+	bPickupWidgetShown = false;
+	bInventoryFullPushed = false;
+}
@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "ItemFocusComponent.generated.h"
+
+/**
+ * Tracks the item under the crosshairs. Only touches the item's pickup widget,
+ * custom depth and inventory full flag when focus moves or those values change.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class SHOOTER_API UItemFocusComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UItemFocusComponent();
+
+	/** Feed this frame's trace result; returns true if the focused item changed */
+	bool UpdateFocus(class AItem* HitItem, float DeltaTime);
+
+	/** Show or hide the focused item's pickup widget */
+	void SetShowPickupWidget(bool bShow);
+
+	/** Tell the focused item whether the inventory is full */
+	void SetInventoryFull(bool bFull);
+
+	/** Drop focus right away and restore the focused item */
+	void ClearFocus();
+
+private:
+	void FocusItem(AItem* Item);
+	void UnfocusItem();
+
+	/** The item currently highlighted for pickup */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Focus, meta = (AllowPrivateAccess = "true"))
+	AItem* FocusedItem;
+
+	/** Item under the crosshairs that is waiting to take focus */
+	UPROPERTY()
+	AItem* CandidateItem;
+
+	/** Time CandidateItem has been under the crosshairs */
+	float CandidateTime;
+
+	/** Time since the trace last hit FocusedItem */
+	float MissedTime;
+
+	/** Time a new item must stay under the crosshairs before it takes focus from another item */
+	UPROPERTY(EditAnywhere, Category = Focus, meta = (AllowPrivateAccess = "true"))
+	float FocusSwitchDelay;
+
+	/** Time the focused item keeps focus after the trace stops hitting it */
+	UPROPERTY(EditAnywhere, Category = Focus, meta = (AllowPrivateAccess = "true"))
+	float FocusLossDelay;
+
+	/** Pickup widget visibility last pushed to FocusedItem */
+	bool bPickupWidgetShown;
+
+	/** Inventory full flag last pushed to FocusedItem */
+	bool bInventoryFull;
+
+	/** False until the inventory full flag has been pushed to FocusedItem */
+	bool bInventoryFullPushed;
+
+public:
+	FORCEINLINE AItem* GetFocusedItem() const { return FocusedItem; }
+};
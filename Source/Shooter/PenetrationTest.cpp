@@ -0,0 +1,174 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+#include "Engine/Engine.h"
+#include "Engine/CollisionProfile.h"
+#include "Components/BoxComponent.h"
+#include "GameFramework/WorldSettings.h"
+#include "ShooterCharacter.h"
+#include "Weapon.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPenetrationExitTest, "Shooter.Penetration.ExitPointAndMaxDepth",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FPenetrationExitTest::RunTest(const FString& Parameters)
+{
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	// A wall 50 units thick, its faces at X = -25 and X = 25
+	UBoxComponent* Wall = NewObject<UBoxComponent>(World->GetWorldSettings());
+	Wall->SetBoxExtent(FVector(25.f, 200.f, 200.f));
+	Wall->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+	Wall->RegisterComponentWithWorld(World);
+
+	const FCollisionQueryParams QueryParams;
+	const FVector Entry{ -25.f, 0.f, 0.f };
+	FVector Exit;
+
+	const FVector Straight{ 1.f, 0.f, 0.f };
+	TestTrue(TEXT("Straight through with depth to spare"),
+		AWeapon::FindPenetrationExit(Wall, Entry, Straight, 60.f, QueryParams, Exit));
+	TestEqual(TEXT("Straight exit is on the far face"), Exit, FVector(25.f, 0.f, 0.f), 0.1f);
+	TestFalse(TEXT("Straight through with too little depth"),
+		AWeapon::FindPenetrationExit(Wall, Entry, Straight, 40.f, QueryParams, Exit));
+
+	// At 45 degrees the path through the wall is 50 * sqrt(2), about 70.7
+	const FVector Angled{ FVector(1.f, 1.f, 0.f).GetSafeNormal() };
+	TestFalse(TEXT("Angled path longer than the depth"),
+		AWeapon::FindPenetrationExit(Wall, Entry, Angled, 60.f, QueryParams, Exit));
+	TestTrue(TEXT("Angled path within the depth"),
+		AWeapon::FindPenetrationExit(Wall, Entry, Angled, 80.f, QueryParams, Exit));
+	TestEqual(TEXT("Angled exit is on the far face"), Exit, FVector(25.f, 50.f, 0.f), 0.1f);
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPenetrationTraceBenchmark, "Shooter.Penetration.DenseGeometryBenchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FPenetrationTraceBenchmark::RunTest(const FString& Parameters)
+{
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	// 32 walls 10 units thick, one every 100 units along X
+	constexpr int32 NumWalls{ 32 };
+	for (int32 WallIndex = 0; WallIndex < NumWalls; WallIndex++)
+	{
+		UBoxComponent* Wall = NewObject<UBoxComponent>(World->GetWorldSettings());
+		Wall->SetBoxExtent(FVector(5.f, 500.f, 500.f));
+		Wall->SetRelativeLocation(FVector(WallIndex * 100.f, 0.f, 0.f));
+		Wall->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+		Wall->RegisterComponentWithWorld(World);
+	}
+
+	// Shots along X through the stack, a little off axis so they don't all take the same path
+	constexpr int32 NumShots{ 2000 };
+	FRandomStream Random(33);
+	TArray<TPair<FVector, FVector>> Shots;
+	Shots.Reserve(NumShots);
+	for (int32 Shot = 0; Shot < NumShots; Shot++)
+	{
+		const FVector Start{ -200.f, Random.FRandRange(-300.f, 300.f), Random.FRandRange(-300.f, 300.f) };
+		const FVector Direction{ FVector(1.f, Random.FRandRange(-0.05f, 0.05f), Random.FRandRange(-0.05f, 0.05f)).GetSafeNormal() };
+		Shots.Emplace(Start, Start + Direction * 5000.f);
+	}
+
+	// A rifle that goes through four walls of up to 20 units each
+	constexpr int32 MaxPenetrations{ 4 };
+	constexpr float MaxDepth{ 20.f };
+
+	constexpr int32 Passes{ 5 };
+	double SingleSeconds{ TNumericLimits<double>::Max() };
+	double SequentialSeconds{ TNumericLimits<double>::Max() };
+	double MultiSeconds{ TNumericLimits<double>::Max() };
+	int32 SequentialHits{ 0 };
+	int32 MultiHits{ 0 };
+	TArray<FHitResult> MultiHitResults;
+	MultiHitResults.Reserve(NumWalls);
+	for (int32 Pass = 0; Pass < Passes; Pass++)
+	{
+		// What SendBullet did before penetration: one trace, stop at the first wall
+		double PassStart{ FPlatformTime::Seconds() };
+		for (const TPair<FVector, FVector>& Shot : Shots)
+		{
+			FCollisionQueryParams QueryParams;
+			QueryParams.bReturnPhysicalMaterial = true;
+			FHitResult HitResult;
+			AShooterCharacter::WeaponTrace(World, HitResult, Shot.Key, Shot.Value, QueryParams);
+		}
+		SingleSeconds = FMath::Min(SingleSeconds, FPlatformTime::Seconds() - PassStart);
+
+		// AShooterCharacter::ProcessBulletHits: a single trace per wall, continued from each exit point
+		SequentialHits = 0;
+		PassStart = FPlatformTime::Seconds();
+		for (const TPair<FVector, FVector>& Shot : Shots)
+		{
+			const FVector Direction{ (Shot.Value - Shot.Key).GetSafeNormal() };
+			FCollisionQueryParams QueryParams;
+			QueryParams.bReturnPhysicalMaterial = true;
+			FHitResult HitResult;
+			FVector Start{ Shot.Key };
+			for (int32 Penetrations = 0; AShooterCharacter::WeaponTrace(World, HitResult, Start, Shot.Value, QueryParams); ++Penetrations)
+			{
+				++SequentialHits;
+				FVector Exit;
+				if (Penetrations >= MaxPenetrations ||
+					!AWeapon::FindPenetrationExit(HitResult.GetComponent(), HitResult.Location, Direction, MaxDepth, QueryParams, Exit))
+				{
+					break;
+				}
+				QueryParams.AddIgnoredComponent(HitResult.GetComponent());
+				Start = Exit;
+			}
+		}
+		SequentialSeconds = FMath::Min(SequentialSeconds, FPlatformTime::Seconds() - PassStart);
+
+		// The alternative: one object type multi-trace for every wall on the line, then the same exit checks
+		MultiHits = 0;
+		PassStart = FPlatformTime::Seconds();
+		for (const TPair<FVector, FVector>& Shot : Shots)
+		{
+			const FVector Direction{ (Shot.Value - Shot.Key).GetSafeNormal() };
+			FCollisionQueryParams QueryParams;
+			QueryParams.bReturnPhysicalMaterial = true;
+			World->LineTraceMultiByObjectType(
+				MultiHitResults, Shot.Key, Shot.Value, FCollisionObjectQueryParams(ECC_WorldStatic), QueryParams);
+			for (int32 HitIndex = 0; HitIndex < MultiHitResults.Num(); HitIndex++)
+			{
+				const FHitResult& HitResult{ MultiHitResults[HitIndex] };
+				++MultiHits;
+				FVector Exit;
+				if (HitIndex >= MaxPenetrations ||
+					!AWeapon::FindPenetrationExit(HitResult.GetComponent(), HitResult.Location, Direction, MaxDepth, QueryParams, Exit))
+				{
+					break;
+				}
+			}
+		}
+		MultiSeconds = FMath::Min(MultiSeconds, FPlatformTime::Seconds() - PassStart);
+	}
+
+	// Both penetration paths have to stop at the same walls for the timing to mean anything
+	TestEqual(TEXT("Sequential and multi-trace penetration hit the same walls"), SequentialHits, MultiHits);
+
+	AddInfo(FString::Printf(TEXT("%d shots through %d walls, up to %d penetrations, best of %d passes"),
+		NumShots, NumWalls, MaxPenetrations, Passes));
+	AddInfo(FString::Printf(TEXT("First hit only: %.2f us per shot"), SingleSeconds * 1e6 / NumShots));
+	AddInfo(FString::Printf(TEXT("Sequential traces: %.2f us per shot, %d hits"), SequentialSeconds * 1e6 / NumShots, SequentialHits));
+	AddInfo(FString::Printf(TEXT("Multi-trace: %.2f us per shot, %d hits"), MultiSeconds * 1e6 / NumShots, MultiHits));
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	return true;
+}
+
+#endif
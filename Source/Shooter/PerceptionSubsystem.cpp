@@ -0,0 +1,148 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PerceptionSubsystem.h"
+#include "Shooter.h"
+#include "Enemy.h"
+#include "EnemyController.h"
+#include "ShooterMemory.h"
+
+DECLARE_CYCLE_STAT(TEXT("Perception Tick"), STAT_PerceptionTick, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Perception Sight Traces"), STAT_PerceptionSightTraces, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Perception Sight Requests"), STAT_PerceptionSightRequests, STATGROUP_Shooter);
+
+static TAutoConsoleVariable<int32> CVarPerceptionTraceBudget(
+	TEXT("shooter.PerceptionTraceBudget"),
+	4,
+	TEXT("Most line of sight traces enemy perception may run in one frame."));
+
+static TAutoConsoleVariable<float> CVarPerceptionResultLifetime(
+	TEXT("shooter.PerceptionResultLifetime"),
+	0.25f,
+	TEXT("Seconds a line of sight result is trusted before it is traced again."));
+
+UPerceptionSubsystem* UPerceptionSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+	return World ? World->GetSubsystem<UPerceptionSubsystem>() : nullptr;
+}
+
+void UPerceptionSubsystem::AddSightRequest(AEnemy* Enemy, AActor* Target)
+{
+	SHOOTER_LLM_SCOPE(AI);
+	if (Enemy == nullptr || Target == nullptr) return;
+
+	for (const FSightRequest& Request : Requests)
+	{
+		if (Request.Enemy == Enemy && Request.Target == Target) return;
+	}
+
+	FSightRequest Request;
+	Request.Enemy = Enemy;
+	Request.Target = Target;
+	Requests.Add(Request);
+	SET_DWORD_STAT(STAT_PerceptionSightRequests, Requests.Num());
+}
+
+void UPerceptionSubsystem::RemoveSightRequest(AEnemy* Enemy, AActor* Target)
+{
+	const int32 Index{ Requests.IndexOfByPredicate([Enemy, Target](const FSightRequest& Request)
+		{
+			return Request.Enemy == Enemy && Request.Target == Target;
+		}) };
+	if (Index == INDEX_NONE) return;
+
+	Requests.RemoveAtSwap(Index);
+	SET_DWORD_STAT(STAT_PerceptionSightRequests, Requests.Num());
+}
+
+bool UPerceptionSubsystem::CanSee(const AEnemy* Enemy, const AActor* Target) const
+{
+	for (const FSightRequest& Request : Requests)
+	{
+		if (Request.Enemy == Enemy && Request.Target == Target)
+		{
+			return Request.bVisible;
+		}
+	}
+	return false;
+}
+
+void UPerceptionSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PerceptionTick);
+
+	const float Now{ GetWorld()->GetTimeSeconds() };
+	const float ResultLifetime{ CVarPerceptionResultLifetime.GetValueOnGameThread() };
+	int32 TracesLeft{ CVarPerceptionTraceBudget.GetValueOnGameThread() };
+
+	// Visit each request at most once a frame, starting where the last frame stopped
+	for (int32 Visited = 0; Visited < Requests.Num() && TracesLeft > 0; ++Visited)
+	{
+		if (NextRequest >= Requests.Num())
+		{
+			NextRequest = 0;
+		}
+
+		FSightRequest& Request = Requests[NextRequest];
+		AEnemy* Enemy = Request.Enemy.Get();
+		AActor* Target = Request.Target.Get();
+		if (Enemy == nullptr || Target == nullptr || Enemy->GetDying())
+		{
+			// Swap in the last request and look at this index again
+			Requests.RemoveAtSwap(NextRequest);
+			SET_DWORD_STAT(STAT_PerceptionSightRequests, Requests.Num());
+			continue;
+		}
+		++NextRequest;
+
+		// Still fresh; the cached result stands
+		if (Request.LastTraceTime >= 0.f && Now - Request.LastTraceTime < ResultLifetime) continue;
+
+		--TracesLeft;
+		Request.LastTraceTime = Now;
+		Request.bVisible = TraceSight(Request);
+		if (Request.bVisible)
+		{
+			AEnemyController* EnemyController = Cast<AEnemyController>(Enemy->GetController());
+			if (EnemyController)
+			{
+				EnemyController->TargetSighted(Target);
+			}
+		}
+	}
+}
+
+bool UPerceptionSubsystem::TraceSight(const FSightRequest& Request) const
+{
+	INC_DWORD_STAT(STAT_PerceptionSightTraces);
+
+	const AEnemy* Enemy = Request.Enemy.Get();
+	const AActor* Target = Request.Target.Get();
+	const APawn* TargetPawn = Cast<APawn>(Target);
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(PerceptionSight), false, Enemy);
+	QueryParams.AddIgnoredActor(Target);
+
+	// Visibility, so overlap-only shapes (agro spheres, item area spheres) don't block sight;
+	// other pawns don't hide the target either
+	FCollisionResponseParams ResponseParams;
+	ResponseParams.CollisionResponse.SetResponse(ECollisionChannel::ECC_Pawn, ECollisionResponse::ECR_Ignore);
+
+	return !GetWorld()->LineTraceTestByChannel(
+		Enemy->GetPawnViewLocation(),
+		TargetPawn ? TargetPawn->GetPawnViewLocation() : Target->GetActorLocation(),
+		ECollisionChannel::ECC_Visibility,
+		QueryParams,
+		ResponseParams);
+}
+
+bool UPerceptionSubsystem::IsTickable() const
+{
+	return Requests.Num() > 0 && !IsTemplate();
+}
+
+TStatId UPerceptionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UPerceptionSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "PerceptionSubsystem.generated.h"
+
+class AEnemy;
+
+/**
+ * Line of sight for enemies with a target in their AgroSphere. Requests are traced
+ * round-robin under a fixed per-frame trace budget, and each result is trusted until
+ * it expires. When the budget can't keep up, enemies keep their last known result,
+ * so the cost per frame stays flat however many enemies are waiting.
+ */
+UCLASS()
+class SHOOTER_API UPerceptionSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	static UPerceptionSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Start checking whether Enemy can see Target */
+	void AddSightRequest(AEnemy* Enemy, AActor* Target);
+
+	void RemoveSightRequest(AEnemy* Enemy, AActor* Target);
+
+	/** Last known result; false until the first trace */
+	bool CanSee(const AEnemy* Enemy, const AActor* Target) const;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+private:
+	struct FSightRequest
+	{
+		TWeakObjectPtr<AEnemy> Enemy;
+		TWeakObjectPtr<AActor> Target;
+
+		/** World time of the last trace, negative until traced */
+		float LastTraceTime{ -1.f };
+		bool bVisible{ false };
+	};
+
+	/** Trace one request; true if Enemy has a clear line to Target */
+	bool TraceSight(const FSightRequest& Request) const;
+
+	TArray<FSightRequest> Requests;
+
+	/** Round-robin position in Requests */
+	int32 NextRequest{ 0 };
+};
@@ -2,5 +2,15 @@
 
 #include "Shooter.h"
 #include "Modules/ModuleManager.h"
+#include "ShooterMemory.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, Shooter, "Shooter" );
+class FShooterModule : public FDefaultGameModuleImpl
+{
+public:
+	virtual void StartupModule() override
+	{
+		ShooterMemory::RegisterLLMTags();
+	}
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FShooterModule, Shooter, "Shooter" );
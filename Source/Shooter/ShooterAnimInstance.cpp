@@ -25,6 +25,10 @@ UShooterAnimInstance::UShooterAnimInstance() :
 	bReloading(false),
 	OffsetState(EOffsetState::EOS_Hip),
 	RecoilWeight(1.0f),
+	RecoilAlpha(0.f),
+	RecoilVelocity(0.f),
+	RecoilStiffness(400.f),
+	RecoilDamping(30.f),
 	bTurningInPlace(false),
 	EquippedWeaponType(EWeaponType::EWT_MAX),
 	bShouldUseFABRIK(false)
@@ -103,6 +107,12 @@ void UShooterAnimInstance::UpdateAnimationProperties(float DeltaTime)
 	}
 	TurnInPlace();
 	Lean(DeltaTime);
+	UpdateRecoil(DeltaTime);
+}
+
+void UShooterAnimInstance::AddRecoilImpulse(float Impulse)
+{
+	RecoilVelocity += Impulse;
 }
 
 void UShooterAnimInstance::NativeInitializeAnimation()
@@ -211,3 +221,22 @@ void UShooterAnimInstance::Lean(float DeltaTime)
 	YawDelta = FMath::Clamp(Interp, -90.f, 90.f);
 
 }
+
+void UShooterAnimInstance::UpdateRecoil(float DeltaTime)
+{
+	// Damped spring pulling RecoilAlpha back to 0, semi-implicit Euler
+	const float Acceleration{ -RecoilStiffness * RecoilAlpha - RecoilDamping * RecoilVelocity };
+	RecoilVelocity += Acceleration * DeltaTime;
+	RecoilAlpha += RecoilVelocity * DeltaTime;
+
+	if (RecoilAlpha > 1.f)
+	{
+		RecoilAlpha = 1.f;
+		RecoilVelocity = FMath::Min(RecoilVelocity, 0.f);
+	}
+	else if (RecoilAlpha < 0.f)
+	{
+		RecoilAlpha = 0.f;
+		RecoilVelocity = FMath::Max(RecoilVelocity, 0.f);
+	}
+}
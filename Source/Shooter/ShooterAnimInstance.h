@@ -34,6 +34,10 @@ public:
 
 	virtual void NativeInitializeAnimation() override;
 
+	/** Kick the recoil spring; RecoilAlpha springs back to rest on its own */
+	UFUNCTION(BlueprintCallable)
+	void AddRecoilImpulse(float Impulse);
+
 protected:
 
 	/** Handle turning in place variables */
@@ -42,6 +46,9 @@ protected:
 	/** Handle calculations for leaning while running */
 	void Lean(float DeltaTime);
 
+	/** Step the recoil spring */
+	void UpdateRecoil(float DeltaTime);
+
 private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Movement, meta = (AllowPrivateAccess = "true"))
 	class AShooterCharacter* ShooterCharacter;
@@ -117,6 +124,21 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	float RecoilWeight;
 
+	/** Weight for the additive recoil pose; driven by the recoil spring */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	float RecoilAlpha;
+
+	/** Rate of change of RecoilAlpha */
+	float RecoilVelocity;
+
+	/** How hard the recoil spring pulls back to rest */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	float RecoilStiffness;
+
+	/** How quickly the recoil spring stops oscillating */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	float RecoilDamping;
+
 	/** True when turning in place */
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	bool bTurningInPlace;
@@ -23,6 +23,51 @@
 #include "Enemy.h"
 #include "EnemyController.h"
 #include "BehaviorTree/BlackboardComponent.h"
+#include "ItemFocusComponent.h"
+#include "ShooterAnimInstance.h"
+#include "Components/AudioComponent.h"
+#include "FXSubsystem.h"
+#include "TracerSubsystem.h"
+#include "SurfaceSubsystem.h"
+#include "FireLatency.h"
+#include "WorldSnapshot.h"
+#include "ShooterMemory.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Shots Fired"), STAT_ShotsFired, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Crosshair Traces Shared"), STAT_CrosshairTracesShared, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Bullet Penetrations"), STAT_BulletPenetrations, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Process Bullet Hits"), STAT_ProcessBulletHits, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Weapon Trace"), STAT_WeaponTrace, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Weapon Trace Capsule Misses"), STAT_WeaponTraceCapsuleMisses, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Weapon Trace Parity Mismatches"), STAT_WeaponTraceParityMismatches, STATGROUP_Shooter);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Fire Voices Started Per Second"), STAT_FireVoicesPerSecond, STATGROUP_Shooter);
+
+static TAutoConsoleVariable<int32> CVarVerifyWeaponTraces(
+	TEXT("shooter.VerifyWeaponTraces"),
+	0,
+	TEXT("Also run the old Visibility trace for every weapon trace and log shots where the enemy or bone hit differs."));
+
+/** Count fire sound voices started by all characters, publishing the rate once a second */
+static void TrackFireVoices(int32 NumStarted)
+{
+#if STATS
+	static double WindowStart{ FPlatformTime::Seconds() };
+	static int32 VoicesInWindow{ 0 };
+	static float VoicesPerSecond{ 0.f };
+
+	VoicesInWindow += NumStarted;
+	const double Now{ FPlatformTime::Seconds() };
+	if (Now - WindowStart >= 1.0)
+	{
+		VoicesPerSecond = static_cast<float>(VoicesInWindow / (Now - WindowStart));
+		WindowStart = Now;
+		VoicesInWindow = 0;
+	}
+	SET_FLOAT_STAT(STAT_FireVoicesPerSecond, VoicesPerSecond);
+#endif
+}
+
+DECLARE_DELEGATE_OneParam(FSlotKeyDelegate, int32);
 
 // Sets default values
 AShooterCharacter::AShooterCharacter() :
@@ -40,6 +85,10 @@ AShooterCharacter::AShooterCharacter() :
 	MouseHipLookUpRate(1.0f),
 	MouseAimingTurnRate(0.6f),
 	MouseAimingLookUpRate(0.6f),
+	// Fire sound loop and montage
+	bFireLoopPlaying(false),
+	FireLoopTailSound(nullptr),
+	bHipFireMontageEveryShot(true),
 	// true when aiming the weapon
 	bAiming(false),
 	// Camera field of view values
@@ -53,18 +102,22 @@ AShooterCharacter::AShooterCharacter() :
 	CrosshairInAirFactor(0.f),
 	CrosshairAimFactor(0.f),
 	CrosshairShootingFactor(0.f),
+	BroadcastCrosshairSpread(-1.f),
+	CrosshairSpreadTolerance(0.01f),
 	// Automatic fire variables
 	bShouldFire(true),
 	bFireButtonPressed(false),
+	MaxShotsPerFrame(4),
+	CrosshairTraceFrame(0),
+	CachedCrosshairBeamLocation(FVector::ZeroVector),
 	// Item trace variables
 	bShouldTraceForItems(false),
+	ItemTraceDistance(1000.f),
 	OverlappedItemCount(0),
 	// Camera interp location variables
 	CameraInterpDistance(250.f),
 	CameraInterpElevation(65.f),
 	// Starting ammo amounts
-	Starting9mmAmmo(85),
-	StartingARAmmo(120),
 	// Combat variables
 	CombatState(ECombatState::ECS_Unoccupied),
 	bCrouching(false),
@@ -140,6 +193,15 @@ AShooterCharacter::AShooterCharacter() :
 
 	InterpComp6 = CreateDefaultSubobject<USceneComponent>(TEXT("Interpolation Component 6"));
 	InterpComp6->SetupAttachment(GetFollowCamera());
+
+	ItemFocus = CreateDefaultSubobject<UItemFocusComponent>(TEXT("ItemFocus"));
+
+	FireAudioComponent = CreateDefaultSubobject<UAudioComponent>(TEXT("FireAudio"));
+	FireAudioComponent->SetupAttachment(GetRootComponent());
+	FireAudioComponent->bAutoActivate = false;
+	FireAudioComponent->bAllowSpatialization = false;
+
+	InventoryComponent = CreateDefaultSubobject<UInventoryComponent>(TEXT("InventoryComponent"));
 }
 
 float AShooterCharacter::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
@@ -202,6 +264,18 @@ void AShooterCharacter::FinishCrosshairBulletFire()
 	bFiringBullet = false;
 }
 
+void AShooterCharacter::PostLoad()
+{
+	Super::PostLoad();
+
+	// A particle system has no colour or speed to carry over, so this takes a pass over the weapon table
+	if (BeamParticles_DEPRECATED && HasAnyFlags(RF_ClassDefaultObject))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s still sets BeamParticles (%s). Tracers now come from each weapon row's TracerStyle; set those, then clear BeamParticles."),
+			*GetClass()->GetName(), *BeamParticles_DEPRECATED->GetName());
+	}
+}
+
 	// Called when the game starts or when spawned
 void AShooterCharacter::BeginPlay()
 {
@@ -212,15 +286,18 @@ void AShooterCharacter::BeginPlay()
 		CameraDefaultFOV = GetFollowCamera()->FieldOfView;
 		CameraCurrentFOV = CameraDefaultFOV;
 	}
+	InventoryComponent->EquipItemDelegate.AddDynamic(this, &AShooterCharacter::OnInventoryEquipItem);
+	InventoryComponent->HighlightIconDelegate.AddDynamic(this, &AShooterCharacter::OnInventoryHighlightIcon);
+
 	// Spawn the default weapon and equip it
 	EquipWeapon(SpawnDefaultWeapon());
-	Inventory.Add(EquippedWeapon);
-	EquippedWeapon->SetSlotIndex(0);
+	// The inventory starts empty, so the default weapon gets a slot of its own rather than joining a stack
+	EquippedWeapon->SetSlotIndex(InventoryComponent->SetItem(InventoryComponent->GetFirstFreeSlot(), EquippedWeapon).Index);
 	EquippedWeapon->DisableCustomDepth();
 	EquippedWeapon->DisableGlowMaterial();
 	EquippedWeapon->SetCharacter(this);
 
-	InitializeAmmoMap();
+	InitializeCarriedAmmo();
 	GetCharacterMovement()->MaxWalkSpeed = BaseMovementSpeed;
 
 	// Create FInterpLocation structs for each interp location. Add to array
@@ -292,19 +369,22 @@ void AShooterCharacter::LookUp(float Value)
 	AddControllerPitchInput(Value * LookUpScaleFactor);
 }
 
-void AShooterCharacter::FireWeapon()
+void AShooterCharacter::FireWeapon(double ShotTime, bool bFirstShot)
 {
 	if (EquippedWeapon == nullptr) return;
 	if (CombatState != ECombatState::ECS_Unoccupied) return;
 
 	if (WeaponHasAmmo())
 	{
+		FFireLatencyTracker::Get().MarkAccepted();
 		PlayFireSound();
-		SendBullet();
-		PlayGunfireMontage();
+		SendBullet(ShotTime);
+		PlayGunfireMontage(bFirstShot);
 		EquippedWeapon->DecrementAmmo();
+		AmmoChangedDelegate.Broadcast();
+		INC_DWORD_STAT(STAT_ShotsFired);
 
-		StartFireTimer();
+		StartFireTimer(ShotTime);
 		// Start bullet fire timer for crosshairs
 		StartCrosshairBulletFire();
 
@@ -321,29 +401,38 @@ bool AShooterCharacter::GetBeamEndLocation(
 	FHitResult& OutHitResult)
 {
 	FVector OutBeamLocation;
-	// Check for crosshair trace hit
-	FHitResult CrosshairHitResult;
-	bool bCrosshairHit = TraceUnderCrosshairs(CrosshairHitResult, OutBeamLocation);
-
-	if (bCrosshairHit)
+	if (CrosshairTraceFrame == GFrameCounter)
 	{
-		// Tentative beam location - still need to trace from gun
-		OutBeamLocation = CrosshairHitResult.Location;
+		// Another shot this frame already traced under the crosshairs
+		OutBeamLocation = CachedCrosshairBeamLocation;
+		INC_DWORD_STAT(STAT_CrosshairTracesShared);
 	}
-	else // no crosshair trace hit
+	else
 	{
-		// OutBeamLocation is the End location for the line trace
+		// Check for crosshair trace hit
+		FHitResult CrosshairHitResult;
+		bool bCrosshairHit = TraceUnderCrosshairs(CrosshairHitResult, OutBeamLocation, ECC_Weapon);
+
+		if (bCrosshairHit)
+		{
+			// Tentative beam location - still need to trace from gun
+			OutBeamLocation = CrosshairHitResult.Location;
+		}
+		else // no crosshair trace hit
+		{
+			// OutBeamLocation is the End location for the line trace
+		}
+		CrosshairTraceFrame = GFrameCounter;
+		CachedCrosshairBeamLocation = OutBeamLocation;
 	}
 
 	// Perform a second trace, this time from the gun barrel
 	const FVector WeaponTraceStart{ MuzzleSocketLocation };
 	const FVector WeaponTraceEnd{ OutBeamLocation };
-	GetWorld()->LineTraceSingleByChannel(
-		OutHitResult,
-		WeaponTraceStart,
-		WeaponTraceEnd,
-		ECollisionChannel::ECC_Visibility);
-	if (!OutHitResult.bBlockingHit) // object between barrel and BeamEndPoint?
+	FCollisionQueryParams QueryParams;
+	QueryParams.bReturnPhysicalMaterial = true;
+	QueryParams.AddIgnoredActor(this);
+	if (!WeaponTrace(GetWorld(), OutHitResult, WeaponTraceStart, WeaponTraceEnd, QueryParams)) // object between barrel and BeamEndPoint?
 	{
 		OutHitResult.Location = OutBeamLocation;
 		return false;
@@ -352,6 +441,96 @@ bool AShooterCharacter::GetBeamEndLocation(
 	return true;
 }
 
+bool AShooterCharacter::WeaponTrace(
+	const UWorld* World,
+	FHitResult& OutHitResult,
+	const FVector& Start,
+	const FVector& End,
+	FCollisionQueryParams& QueryParams)
+{
+	const bool bHit{ TraceWeaponChannel(World, OutHitResult, Start, End, QueryParams) };
+
+	if (CVarVerifyWeaponTraces.GetValueOnGameThread() != 0)
+	{
+		FString Mismatch;
+		if (!CheckHitZoneParity(World, OutHitResult, Start, End, QueryParams, Mismatch))
+		{
+			INC_DWORD_STAT(STAT_WeaponTraceParityMismatches);
+			UE_LOG(LogTemp, Warning, TEXT("Weapon trace parity: %s"), *Mismatch);
+		}
+	}
+	return bHit;
+}
+
+bool AShooterCharacter::CheckHitZoneParity(
+	const UWorld* World,
+	const FHitResult& WeaponHit,
+	const FVector& Start,
+	const FVector& End,
+	const FCollisionQueryParams& QueryParams,
+	FString& OutMismatch)
+{
+	// Enemy meshes still block Visibility, so this is the single trace weapons made before ECC_Weapon
+	FHitResult VisibilityHit;
+	World->LineTraceSingleByChannel(VisibilityHit, Start, End, ECollisionChannel::ECC_Visibility, QueryParams);
+
+	const AEnemy* WeaponEnemy = Cast<AEnemy>(WeaponHit.GetActor());
+	const AEnemy* VisibilityEnemy = Cast<AEnemy>(VisibilityHit.GetActor());
+	if (WeaponEnemy == nullptr && VisibilityEnemy == nullptr) return true;
+	if (WeaponEnemy == VisibilityEnemy && WeaponHit.BoneName == VisibilityHit.BoneName) return true;
+
+	OutMismatch = FString::Printf(TEXT("weapon trace hit %s (%s), visibility trace hit %s (%s)"),
+		*GetNameSafe(WeaponEnemy), *WeaponHit.BoneName.ToString(),
+		*GetNameSafe(VisibilityEnemy), *VisibilityHit.BoneName.ToString());
+	return false;
+}
+
+bool AShooterCharacter::TraceWeaponChannel(
+	const UWorld* World,
+	FHitResult& OutHitResult,
+	const FVector& Start,
+	const FVector& End,
+	FCollisionQueryParams& QueryParams)
+{
+	SCOPE_CYCLE_COUNTER(STAT_WeaponTrace);
+
+	// Each capsule the trace slips past is ignored, so a crowd costs one retrace per miss
+	constexpr int32 MaxCapsuleMisses{ 8 };
+	for (int32 Misses = 0; Misses <= MaxCapsuleMisses; ++Misses)
+	{
+		if (!World->LineTraceSingleByChannel(
+			OutHitResult,
+			Start,
+			End,
+			ECC_Weapon,
+			QueryParams))
+		{
+			return false;
+		}
+
+		AEnemy* HitEnemy = Cast<AEnemy>(OutHitResult.GetActor());
+		if (HitEnemy == nullptr || OutHitResult.GetComponent() != HitEnemy->GetCapsuleComponent())
+		{
+			return true;
+		}
+
+		FHitResult ZoneHitResult;
+		if (HitEnemy->TraceHitZone(ZoneHitResult, Start, End, QueryParams))
+		{
+			OutHitResult = ZoneHitResult;
+			OutHitResult.bBlockingHit = true;
+			return true;
+		}
+
+		// Passed through the capsule without touching a body
+		INC_DWORD_STAT(STAT_WeaponTraceCapsuleMisses);
+		QueryParams.AddIgnoredComponent(HitEnemy->GetCapsuleComponent());
+	}
+
+	OutHitResult = FHitResult{};
+	return false;
+}
+
 void AShooterCharacter::AimingButtonPressed()
 {
 	bAimingButtonPressed = true;
@@ -482,32 +661,37 @@ void AShooterCharacter::CalculateCrosshairSpread(float DeltaTime)
 		CrosshairInAirFactor -
 		CrosshairAimFactor +
 		CrosshairShootingFactor;
+
+	// The spread settles when nothing changes, so the HUD hears nothing most frames
+	if (!FMath::IsNearlyEqual(CrosshairSpreadMultiplier, BroadcastCrosshairSpread, CrosshairSpreadTolerance))
+	{
+		BroadcastCrosshairSpread = CrosshairSpreadMultiplier;
+		CrosshairSpreadDelegate.Broadcast(CrosshairSpreadMultiplier);
+	}
 }
 
 void AShooterCharacter::FireButtonPressed()
 {
 	bFireButtonPressed = true;
-	FireWeapon();
+	FFireLatencyTracker::Get().MarkInput();
+	FireWeapon(GetWorld()->GetTimeSeconds(), true);
 }
 
 void AShooterCharacter::FireButtonReleased()
 {
 	bFireButtonPressed = false;
+	FFireLatencyTracker::Get().MarkRelease();
 }
 
-void AShooterCharacter::StartFireTimer()
+void AShooterCharacter::StartFireTimer(double ShotTime)
 {
 	if (EquippedWeapon == nullptr) return;
 	CombatState = ECombatState::ECS_FireTimerInProgress;
 
-	GetWorldTimerManager().SetTimer(
-		AutoFireTimer,
-		this,
-		&AShooterCharacter::AutoFireReset,
-		EquippedWeapon->GetAutoFireRate());
+	FireScheduler.ShotFired(ShotTime, EquippedWeapon->GetAutoFireRate());
 }
 
-void AShooterCharacter::AutoFireReset()
+void AShooterCharacter::AutoFireReset(double ShotTime)
 {
 	if (CombatState == ECombatState::ECS_Stunned) return;
 
@@ -518,7 +702,7 @@ void AShooterCharacter::AutoFireReset()
 	{
 		if (bFireButtonPressed && EquippedWeapon->GetAutomatic())
 		{
-			FireWeapon();
+			FireWeapon(ShotTime, false);
 		}
 	}
 	else
@@ -528,9 +712,35 @@ void AShooterCharacter::AutoFireReset()
 	}
 }
 
+void AShooterCharacter::UpdateAutoFire()
+{
+	const double Now{ GetWorld()->GetTimeSeconds() };
+	int32 ShotsThisFrame{ 0 };
+
+	// Each pass fires the shot that was due at GetNextShotTime(), so a slow frame fires several
+	while (CombatState == ECombatState::ECS_FireTimerInProgress && FireScheduler.IsShotDue(Now))
+	{
+		if (ShotsThisFrame >= MaxShotsPerFrame)
+		{
+			FireScheduler.CatchUp(Now);
+			break;
+		}
+		AutoFireReset(FireScheduler.GetNextShotTime());
+		++ShotsThisFrame;
+	}
+
+	// Released, reloading, stunned or switching weapons
+	if (CombatState != ECombatState::ECS_FireTimerInProgress)
+	{
+		StopFireLoop();
+	}
+}
+
 bool AShooterCharacter::TraceUnderCrosshairs(
 	FHitResult& OutHitResult,
-	FVector& OutHitLocation)
+	FVector& OutHitLocation,
+	ECollisionChannel TraceChannel,
+	float TraceDistance)
 {
 	// Get Viewport Size
 	FVector2D ViewportSize;
@@ -555,13 +765,22 @@ bool AShooterCharacter::TraceUnderCrosshairs(
 	{
 		// Trace from Crosshair world location outward
 		const FVector Start{ CrosshairWorldPosition };
-		const FVector End{ Start + CrosshairWorldDirection * 50'000.f };
+		const FVector End{ Start + CrosshairWorldDirection * TraceDistance };
 		OutHitLocation = End;
-		GetWorld()->LineTraceSingleByChannel(
-			OutHitResult,
-			Start,
-			End,
-			ECollisionChannel::ECC_Visibility);
+		if (TraceChannel == ECC_Weapon)
+		{
+			FCollisionQueryParams QueryParams;
+			QueryParams.AddIgnoredActor(this);
+			WeaponTrace(GetWorld(), OutHitResult, Start, End, QueryParams);
+		}
+		else
+		{
+			GetWorld()->LineTraceSingleByChannel(
+				OutHitResult,
+				Start,
+				End,
+				TraceChannel);
+		}
 		if (OutHitResult.bBlockingHit)
 		{
 			OutHitLocation = OutHitResult.Location;
@@ -575,13 +794,15 @@ void AShooterCharacter::TraceForItems()
 {
 	if (bShouldTraceForItems)
 	{
+		// Only pickup boxes respond to the Interactable channel
 		FHitResult ItemTraceResult;
 		FVector HitLocation;
-		TraceUnderCrosshairs(ItemTraceResult, HitLocation);
+		TraceUnderCrosshairs(ItemTraceResult, HitLocation, ECC_Interactable, ItemTraceDistance);
+		AItem* HitItem{ nullptr };
 		if (ItemTraceResult.bBlockingHit)
 		{
-			TraceHitItem = Cast<AItem>(ItemTraceResult.Actor);
-			const auto TraceHitWeapon = Cast<AWeapon>(TraceHitItem);
+			HitItem = Cast<AItem>(ItemTraceResult.Actor);
+			const auto TraceHitWeapon = Cast<AWeapon>(HitItem);
 			if (TraceHitWeapon)
 			{
 				if (HighlightedSlot == -1)
@@ -600,55 +821,28 @@ void AShooterCharacter::TraceForItems()
 				}
 			}
 
-			if (TraceHitItem && TraceHitItem->GetItemState() == EItemState::EIS_EquipInterping)
+			if (HitItem && HitItem->GetItemState() == EItemState::EIS_EquipInterping)
 			{
-				TraceHitItem = nullptr;
-			}
-
-			if (TraceHitItem && TraceHitItem->GetPickupWidget())
-			{
-
-				if (ItemGuids.Contains(TraceHitItem->GetGuid()))
-				{
-					// Show Item's Pickup Widget
-					TraceHitItem->GetPickupWidget()->SetVisibility(true);
-				}
-
-				TraceHitItem->EnableCustomDepth();
-
-				if (Inventory.Num() >= INVENTORY_CAPACITY)
-				{
-					// Inventory is full
-					TraceHitItem->SetCharacterInventoryFull(true);
-				}
-				else
-				{
-					// Inventory has room
-					TraceHitItem->SetCharacterInventoryFull(false);
-				}
+				HitItem = nullptr;
 			}
+		}
 
-			// We hit an AItem last frame
-			if (TraceHitItemLastFrame)
-			{
-				if (TraceHitItem != TraceHitItemLastFrame)
-				{
-					// We are hitting a different AItem this frame from last frame
-					// Or AItem is null.
-					TraceHitItemLastFrame->GetPickupWidget()->SetVisibility(false);
-					TraceHitItemLastFrame->DisableCustomDepth();
-				}
-			}
-			// Store a reference to HitItem for next frame
-			TraceHitItemLastFrame = TraceHitItem;
+		// Only changes in focus touch the item's widget and custom depth
+		ItemFocus->UpdateFocus(HitItem, GetWorld()->GetDeltaSeconds());
+		TraceHitItem = ItemFocus->GetFocusedItem();
+		if (TraceHitItem)
+		{
+			// Show Item's Pickup Widget
+			ItemFocus->SetShowPickupWidget(ItemGuids.Contains(TraceHitItem->GetGuid()));
+			ItemFocus->SetInventoryFull(InventoryComponent->IsFull());
 		}
 	}
-	else if (TraceHitItemLastFrame)
+	else if (ItemFocus->GetFocusedItem())
 	{
 		// No longer overlapping any items,
 		// Item last frame should not show widget
-		TraceHitItemLastFrame->GetPickupWidget()->SetVisibility(false);
-		TraceHitItemLastFrame->DisableCustomDepth();
+		ItemFocus->ClearFocus();
+		TraceHitItem = nullptr;
 	}
 }
 
@@ -680,17 +874,18 @@ void AShooterCharacter::EquipWeapon(AWeapon* WeaponToEquip, bool bSwapping)
 		if (EquippedWeapon == nullptr)
 		{
 			// -1 == no EquippedWeapon yet. No need to reverse the icon animation
-			EquipItemDelegate.Broadcast(-1, WeaponToEquip->GetSlotIndex());
+			InventoryComponent->QueueEquipNotify(-1, WeaponToEquip->GetSlotIndex());
 		}
 		else if (!bSwapping)
 		{
-			EquipItemDelegate.Broadcast(EquippedWeapon->GetSlotIndex(), WeaponToEquip->GetSlotIndex());
+			InventoryComponent->QueueEquipNotify(EquippedWeapon->GetSlotIndex(), WeaponToEquip->GetSlotIndex());
 		}
 
 		// Set EquippedWeapon to the newly spawned Weapon
 		EquippedWeapon = WeaponToEquip;
 
 		EquippedWeapon->SetItemState(EItemState::EIS_Equipped);
+		EquippedWeaponDelegate.Broadcast(EquippedWeapon);
 	}
 }
 
@@ -723,22 +918,146 @@ void AShooterCharacter::SelectButtonReleased()
 void AShooterCharacter::SwapWeapon(AWeapon* WeaponToSwap)
 {
 
-	if (Inventory.Num() - 1 >= EquippedWeapon->GetSlotIndex())
+	if (InventoryComponent->SetItem(EquippedWeapon->GetSlotIndex(), WeaponToSwap).IsValid())
 	{
-		Inventory[EquippedWeapon->GetSlotIndex()] = WeaponToSwap;
 		WeaponToSwap->SetSlotIndex(EquippedWeapon->GetSlotIndex());
 	}
 
 	DropWeapon();
 	EquipWeapon(WeaponToSwap, true);
 	TraceHitItem = nullptr;
-	TraceHitItemLastFrame = nullptr;
+	ItemFocus->ClearFocus();
+}
+
+void AShooterCharacter::InitializeCarriedAmmo()
+{
+	CarriedAmmo.Reset();
+
+	const UAmmoTypeSubsystem* AmmoTypes = UAmmoTypeSubsystem::Get(this);
+	if (AmmoTypes == nullptr) return;
+
+	CarriedAmmo.SetNumZeroed(AmmoTypes->GetNumAmmoTypes());
+	for (int32 Id = 0; Id < CarriedAmmo.Num(); Id++)
+	{
+		CarriedAmmo[Id] = AmmoTypes->GetAmmoType(Id)->StartingAmmo;
+	}
+	AmmoChangedDelegate.Broadcast();
+}
+
+int32 AShooterCharacter::GetCarriedAmmo(int32 AmmoTypeId) const
+{
+	return CarriedAmmo.IsValidIndex(AmmoTypeId) ? CarriedAmmo[AmmoTypeId] : 0;
+}
+
+int32 AShooterCharacter::GetCarriedAmmoOfType(EAmmoType AmmoType) const
+{
+	const UAmmoTypeSubsystem* AmmoTypes = UAmmoTypeSubsystem::Get(this);
+	return AmmoTypes ? GetCarriedAmmo(AmmoTypes->GetLegacyAmmoTypeId(AmmoType)) : 0;
+}
+
+TMap<EAmmoType, int32> AShooterCharacter::GetAmmoMap() const
+{
+	TMap<EAmmoType, int32> AmmoMap;
+	const UAmmoTypeSubsystem* AmmoTypes = UAmmoTypeSubsystem::Get(this);
+	if (AmmoTypes == nullptr) return AmmoMap;
+
+	for (int32 Type = 0; Type < static_cast<int32>(EAmmoType::EAT_NAX); Type++)
+	{
+		const int32 Id{ AmmoTypes->GetLegacyAmmoTypeId(static_cast<EAmmoType>(Type)) };
+		if (CarriedAmmo.IsValidIndex(Id))
+		{
+			AmmoMap.Add(static_cast<EAmmoType>(Type), CarriedAmmo[Id]);
+		}
+	}
+	return AmmoMap;
+}
+
+void AShooterCharacter::CaptureSnapshot(FPlayerSnapshot& Snapshot) const
+{
+	Snapshot.Location = GetActorLocation();
+	Snapshot.Rotation = GetActorRotation();
+	Snapshot.ControlRotation = GetControlRotation();
+	Snapshot.Health = Health;
+
+	if (const UAmmoTypeSubsystem* AmmoTypes = UAmmoTypeSubsystem::Get(this))
+	{
+		for (int32 Id = 0; Id < CarriedAmmo.Num(); Id++)
+		{
+			Snapshot.CarriedAmmo.Add(AmmoTypes->GetAmmoTypeName(Id), CarriedAmmo[Id]);
+		}
+	}
+
+	const int32 Capacity{ InventoryComponent->GetCapacity() };
+	Snapshot.InventoryItems.SetNum(Capacity);
+	Snapshot.StackCounts.SetNum(Capacity);
+	for (int32 SlotIndex = 0; SlotIndex < Capacity; SlotIndex++)
+	{
+		const AItem* Item = InventoryComponent->GetItem(SlotIndex);
+		Snapshot.InventoryItems[SlotIndex] = Item ? Item->GetFName() : NAME_None;
+		Snapshot.StackCounts[SlotIndex] = InventoryComponent->GetStackCount(SlotIndex);
+	}
+	Snapshot.EquippedSlot = EquippedWeapon ? EquippedWeapon->GetSlotIndex() : INDEX_NONE;
 }
 
-void AShooterCharacter::InitializeAmmoMap()
+void AShooterCharacter::RestoreSnapshot(const FPlayerSnapshot& Snapshot, const TArray<AItem*>& InventoryItems)
 {
-	AmmoMap.Add(EAmmoType::EAT_9mm, Starting9mmAmmo);
-	AmmoMap.Add(EAmmoType::EAT_AR, StartingARAmmo);
+	GetCharacterMovement()->StopMovementImmediately();
+	SetActorLocationAndRotation(Snapshot.Location, Snapshot.Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+	if (Controller)
+	{
+		Controller->SetControlRotation(Snapshot.ControlRotation);
+	}
+	Health = FMath::Clamp(Snapshot.Health, 0.f, MaxHealth);
+
+	// Ammo types no longer in the table are dropped; new ones start empty
+	CarriedAmmo.Reset();
+	if (const UAmmoTypeSubsystem* AmmoTypes = UAmmoTypeSubsystem::Get(this))
+	{
+		CarriedAmmo.SetNumZeroed(AmmoTypes->GetNumAmmoTypes());
+		for (const TPair<FName, int32>& Ammo : Snapshot.CarriedAmmo)
+		{
+			const int32 Id{ AmmoTypes->FindAmmoTypeId(Ammo.Key) };
+			if (CarriedAmmo.IsValidIndex(Id))
+			{
+				CarriedAmmo[Id] = Ammo.Value;
+			}
+		}
+	}
+
+	// Drop whatever was going on; the restored items may not be the ones it referred to
+	if (bAiming)
+	{
+		StopAiming();
+	}
+	CombatState = ECombatState::ECS_Unoccupied;
+	TraceHitItem = nullptr;
+	ItemFocus->ClearFocus();
+
+	EquippedWeapon = nullptr;
+	for (int32 SlotIndex = 0; SlotIndex < InventoryComponent->GetCapacity(); SlotIndex++)
+	{
+		AItem* Item = InventoryItems.IsValidIndex(SlotIndex) ? InventoryItems[SlotIndex] : nullptr;
+		InventoryComponent->SetItem(SlotIndex, Item);
+		if (Item)
+		{
+			InventoryComponent->SetStackCount(SlotIndex, Snapshot.StackCounts.IsValidIndex(SlotIndex) ? Snapshot.StackCounts[SlotIndex] : 1);
+			Item->SetSlotIndex(SlotIndex);
+			Item->SetCharacter(this);
+			Item->DisableCustomDepth();
+			Item->DisableGlowMaterial();
+		}
+	}
+
+	AWeapon* Weapon = Cast<AWeapon>(InventoryComponent->GetItem(Snapshot.EquippedSlot));
+	if (Weapon)
+	{
+		EquipWeapon(Weapon);
+	}
+	else
+	{
+		EquippedWeaponDelegate.Broadcast(nullptr);
+	}
+	AmmoChangedDelegate.Broadcast();
 }
 
 bool AShooterCharacter::WeaponHasAmmo()
@@ -750,14 +1069,43 @@ bool AShooterCharacter::WeaponHasAmmo()
 
 void AShooterCharacter::PlayFireSound()
 {
+	// Automatic weapons keep one looping voice going while they fire
+	if (EquippedWeapon->GetAutomatic() && EquippedWeapon->GetFireLoopSound())
+	{
+		if (!bFireLoopPlaying)
+		{
+			FireAudioComponent->SetSound(EquippedWeapon->GetFireLoopSound());
+			FireAudioComponent->Play();
+			FireLoopTailSound = EquippedWeapon->GetFireTailSound();
+			bFireLoopPlaying = true;
+			TrackFireVoices(1);
+		}
+		return;
+	}
+
 	// Play fire sound
 	if (EquippedWeapon->GetFireSound())
 	{
 		UGameplayStatics::PlaySound2D(this, EquippedWeapon->GetFireSound());
+		TrackFireVoices(1);
 	}
 }
 
-void AShooterCharacter::SendBullet()
+void AShooterCharacter::StopFireLoop()
+{
+	if (!bFireLoopPlaying) return;
+	bFireLoopPlaying = false;
+
+	FireAudioComponent->Stop();
+	if (FireLoopTailSound)
+	{
+		FireAudioComponent->SetSound(FireLoopTailSound);
+		FireAudioComponent->Play();
+		TrackFireVoices(1);
+	}
+}
+
+void AShooterCharacter::SendBullet(double ShotTime)
 {
 	// Send bullet
 	const USkeletalMeshSocket* BarrelSocket =
@@ -767,87 +1115,176 @@ void AShooterCharacter::SendBullet()
 		const FTransform SocketTransform = BarrelSocket->GetSocketTransform(
 			EquippedWeapon->GetItemMesh());
 
-		if (EquippedWeapon->GetMuzzleFlash())
+		UFXSubsystem* FX = UFXSubsystem::Get(this);
+		if (FX && EquippedWeapon->GetMuzzleFlash())
 		{
-			UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), EquippedWeapon->GetMuzzleFlash(), SocketTransform);
+			FX->SpawnEmitter(EquippedWeapon->GetMuzzleFlash(), SocketTransform);
 		}
+		FFireLatencyTracker::Get().MarkMuzzleFlash();
 
 		FHitResult BeamHitResult;
 		bool bBeamEnd = GetBeamEndLocation(
 			SocketTransform.GetLocation(), BeamHitResult);
 		if (bBeamEnd)
 		{
-			// Does hit Actor implement BulletHitInterface?
-			if (BeamHitResult.Actor.IsValid())
-			{
-				IBulletHitInterface* BulletHitInterface = Cast<IBulletHitInterface>(BeamHitResult.Actor.Get());
-				if (BulletHitInterface)
-				{
-					BulletHitInterface->BulletHit_Implementation(BeamHitResult, this, GetController());
-				}
+			const FVector BeamEnd{ ProcessBulletHits(SocketTransform.GetLocation(), BeamHitResult) };
 
-				AEnemy* HitEnemy = Cast<AEnemy>(BeamHitResult.Actor.Get());
-				if (HitEnemy)
-				{
-					int32 Damage{};
-					if (BeamHitResult.BoneName.ToString() == HitEnemy->GetHeadBone())
-					{
-						// Head shot
-						Damage = EquippedWeapon->GetHeadShotDamage();
-						UGameplayStatics::ApplyDamage(
-							BeamHitResult.Actor.Get(),
-							Damage,
-							GetController(),
-							this,
-							UDamageType::StaticClass());
-						HitEnemy->ShowHitNumber(Damage, BeamHitResult.Location, true);
-					}
-					else
-					{
-						// Body shot
-						Damage = EquippedWeapon->GetDamage();
-						UGameplayStatics::ApplyDamage(
-							BeamHitResult.Actor.Get(),
-							Damage,
-							GetController(),
-							this,
-							UDamageType::StaticClass());
-						HitEnemy->ShowHitNumber(Damage, BeamHitResult.Location, false);
-					}
-					
-					
-				}
-			}
-			else
+			// Tracer starts from when the shot was due, so shots late in a frame are already under way
+			UTracerSubsystem* Tracers = UTracerSubsystem::Get(this);
+			if (Tracers)
 			{
-				// Spawn default particles
-				if (ImpactParticles)
-				{
-					UGameplayStatics::SpawnEmitterAtLocation(
-						GetWorld(),
-						ImpactParticles,
-						BeamHitResult.Location);
-				}
+				Tracers->AddTracer(
+					SocketTransform.GetLocation(),
+					BeamEnd,
+					static_cast<float>(ShotTime),
+					EquippedWeapon->GetTracerStyle());
 			}
+		}
+		FFireLatencyTracker::Get().MarkTraceResolved();
+	}
+}
+
+FVector AShooterCharacter::ProcessBulletHits(const FVector& TraceStart, const FHitResult& FirstHit)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ProcessBulletHits);
+
+	const FVector Direction{ (FirstHit.Location - TraceStart).GetSafeNormal() };
+	const FVector TraceEnd{ TraceStart + Direction * 50'000.f };
+
+	FCollisionQueryParams QueryParams;
+	QueryParams.bReturnPhysicalMaterial = true;
+	QueryParams.AddIgnoredActor(this);
+
+	// Hits are applied as they are found, so nothing needs to be stored
+	FHitResult HitResult{ FirstHit };
+	float DamageScale{ 1.f };
+	for (int32 Penetrations = 0; ; ++Penetrations)
+	{
+		ApplyBulletHit(HitResult, DamageScale);
+
+		if (Penetrations >= EquippedWeapon->GetMaxPenetrations()) break;
+
+		UPrimitiveComponent* HitComponent = HitResult.GetComponent();
+		const FSurfacePenetration* Penetration = EquippedWeapon->FindSurfacePenetration(
+			UPhysicalMaterial::DetermineSurfaceType(HitResult.PhysMaterial.Get()));
+		if (HitComponent == nullptr || Penetration == nullptr) break;
+
+		FVector ExitLocation;
+		if (!AWeapon::FindPenetrationExit(
+			HitComponent, HitResult.Location, Direction, Penetration->MaxDepth, QueryParams, ExitLocation))
+		{
+			break;
+		}
+
+		DamageScale *= 1.f - Penetration->DamageLoss;
+		if (DamageScale <= KINDA_SMALL_NUMBER) break;
+		INC_DWORD_STAT(STAT_BulletPenetrations);
+
+		// Carry on from the exit point, never hitting the same component twice
+		QueryParams.AddIgnoredComponent(HitComponent);
+		AEnemy* HitEnemy = Cast<AEnemy>(HitResult.GetActor());
+		if (HitEnemy)
+		{
+			// Its capsule would only lead back to the mesh just passed through
+			QueryParams.AddIgnoredComponent(HitEnemy->GetCapsuleComponent());
+		}
+		if (!WeaponTrace(GetWorld(), HitResult, ExitLocation, TraceEnd, QueryParams))
+		{
+			return TraceEnd;
+		}
+	}
 
+	return HitResult.Location;
+}
+
+void AShooterCharacter::ApplyBulletHit(const FHitResult& HitResult, float DamageScale)
+{
+	// Does hit Actor implement BulletHitInterface?
+	if (HitResult.Actor.IsValid())
+	{
+		IBulletHitInterface* BulletHitInterface = Cast<IBulletHitInterface>(HitResult.Actor.Get());
+		if (BulletHitInterface)
+		{
+			BulletHitInterface->BulletHit_Implementation(HitResult, this, GetController());
+		}
+		else
+		{
+			SpawnSurfaceImpact(HitResult);
+		}
 
-			UParticleSystemComponent* Beam = UGameplayStatics::SpawnEmitterAtLocation(
-				GetWorld(),
-				BeamParticles,
-				SocketTransform);
-			if (Beam)
+		AEnemy* HitEnemy = Cast<AEnemy>(HitResult.Actor.Get());
+		if (HitEnemy)
+		{
+			int32 Damage{};
+			const bool bHeadShot{ HitResult.BoneName.ToString() == HitEnemy->GetHeadBone() };
+			if (bHeadShot)
 			{
-				Beam->SetVectorParameter(FName("Target"), BeamHitResult.Location);
+				// Head shot
+				Damage = EquippedWeapon->GetHeadShotDamage() * DamageScale;
+				UGameplayStatics::ApplyDamage(
+					HitResult.Actor.Get(),
+					Damage,
+					GetController(),
+					this,
+					UDamageType::StaticClass());
 			}
+			else
+			{
+				// Body shot
+				Damage = EquippedWeapon->GetDamage() * DamageScale;
+				UGameplayStatics::ApplyDamage(
+					HitResult.Actor.Get(),
+					Damage,
+					GetController(),
+					this,
+					UDamageType::StaticClass());
+			}
+
+			// The Blueprint creates the hit number widget
+			SHOOTER_LLM_SCOPE(HitNumbers);
+			HitEnemy->ShowHitNumber(Damage, HitResult.Location, bHeadShot);
 		}
 	}
+	else
+	{
+		SpawnSurfaceImpact(HitResult);
+	}
 }
 
-void AShooterCharacter::PlayGunfireMontage()
+void AShooterCharacter::SpawnSurfaceImpact(const FHitResult& HitResult)
+{
+	// Same surface lookup as footsteps; the trace already returned the physical material
+	const USurfaceSubsystem* Surfaces = USurfaceSubsystem::Get(this);
+	const FSurfaceEffectsTable* Effects = Surfaces ?
+		Surfaces->GetSurfaceEffects(UPhysicalMaterial::DetermineSurfaceType(HitResult.PhysMaterial.Get())) :
+		nullptr;
+
+	// Spawn the surface's particles, or the default ones
+	UParticleSystem* Particles = Effects && Effects->ImpactParticles ? Effects->ImpactParticles : ImpactParticles;
+	UFXSubsystem* FX = UFXSubsystem::Get(this);
+	if (FX && Particles)
+	{
+		FX->SpawnImpact(Particles, HitResult.Location);
+	}
+	if (Effects && Effects->ImpactSound)
+	{
+		UGameplayStatics::PlaySoundAtLocation(this, Effects->ImpactSound, HitResult.Location);
+	}
+}
+
+void AShooterCharacter::PlayGunfireMontage(bool bFirstShot)
 {
-	// Play Hip Fire Montage
 	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
-	if (AnimInstance && HipFireMontage)
+
+	// Every shot drives the additive recoil pose
+	UShooterAnimInstance* ShooterAnimInstance = Cast<UShooterAnimInstance>(AnimInstance);
+	if (ShooterAnimInstance)
+	{
+		ShooterAnimInstance->AddRecoilImpulse(EquippedWeapon->GetRecoilImpulse());
+	}
+
+	// Play Hip Fire Montage
+	if (AnimInstance && HipFireMontage && (bFirstShot || bHipFireMontageEveryShot))
 	{
 		AnimInstance->Montage_Play(HipFireMontage);
 		AnimInstance->Montage_JumpToSection(FName("StartFire"));
@@ -888,14 +1325,7 @@ bool AShooterCharacter::CarryingAmmo()
 {
 	if (EquippedWeapon == nullptr) return false;
 
-	auto AmmoType = EquippedWeapon->GetAmmoType();
-
-	if (AmmoMap.Contains(AmmoType))
-	{
-		return AmmoMap[AmmoType] > 0;
-	}
-
-	return false;
+	return GetCarriedAmmo(EquippedWeapon->GetAmmoTypeId()) > 0;
 }
 
 void AShooterCharacter::GrabClip()
@@ -989,17 +1419,23 @@ void AShooterCharacter::StopAiming()
 
 void AShooterCharacter::PickupAmmo(AAmmo* Ammo)
 {
-	// check to see if AmmoMap contains Ammo's AmmoType
-	if (AmmoMap.Find(Ammo->GetAmmoType()))
+	const int32 AmmoTypeId{ Ammo->GetAmmoTypeId() };
+	if (CarriedAmmo.IsValidIndex(AmmoTypeId))
 	{
-		// Get amount of ammo in our AmmoMap for Ammo's type
-		int32 AmmoCount{ AmmoMap[Ammo->GetAmmoType()] };
-		AmmoCount += Ammo->GetItemCount();
-		// Set the amount of ammo in the Map for this type
-		AmmoMap[Ammo->GetAmmoType()] = AmmoCount;
+		int32 AmmoCount{ CarriedAmmo[AmmoTypeId] + Ammo->GetItemCount() };
+
+		// Clamp to the most we can carry of this type, if it has a limit
+		const UAmmoTypeSubsystem* AmmoTypes = UAmmoTypeSubsystem::Get(this);
+		const FAmmoTypeTable* AmmoTypeRow = AmmoTypes ? AmmoTypes->GetAmmoType(AmmoTypeId) : nullptr;
+		if (AmmoTypeRow && AmmoTypeRow->MaxCarriedAmmo > 0)
+		{
+			AmmoCount = FMath::Min(AmmoCount, AmmoTypeRow->MaxCarriedAmmo);
+		}
+		CarriedAmmo[AmmoTypeId] = AmmoCount;
+		AmmoChangedDelegate.Broadcast();
 	}
 
-	if (EquippedWeapon->GetAmmoType() == Ammo->GetAmmoType())
+	if (EquippedWeapon->GetAmmoTypeId() == AmmoTypeId)
 	{
 		// Check to see if the gun is empty
 		if (EquippedWeapon->GetAmmo() == 0)
@@ -1035,47 +1471,17 @@ void AShooterCharacter::InitializeInterpLocations()
 	InterpLocations.Add(InterpLoc6);
 }
 
-void AShooterCharacter::FKeyPressed()
-{
-	if (EquippedWeapon->GetSlotIndex() == 0) return;
-	ExchangeInventoryItems(EquippedWeapon->GetSlotIndex(), 0);
-}
-
-void AShooterCharacter::OneKeyPressed()
-{
-	if (EquippedWeapon->GetSlotIndex() == 1) return;
-	ExchangeInventoryItems(EquippedWeapon->GetSlotIndex(), 1);
-}
-
-void AShooterCharacter::TwoKeyPressed()
-{
-	if (EquippedWeapon->GetSlotIndex() == 2) return;
-	ExchangeInventoryItems(EquippedWeapon->GetSlotIndex(), 2);
-}
-
-void AShooterCharacter::ThreeKeyPressed()
-{
-	if (EquippedWeapon->GetSlotIndex() == 3) return;
-	ExchangeInventoryItems(EquippedWeapon->GetSlotIndex(), 3);
-}
-
-void AShooterCharacter::FourKeyPressed()
+void AShooterCharacter::SlotKeyPressed(int32 SlotIndex)
 {
-	if (EquippedWeapon->GetSlotIndex() == 4) return;
-	ExchangeInventoryItems(EquippedWeapon->GetSlotIndex(), 4);
-}
-
-void AShooterCharacter::FiveKeyPressed()
-{
-	if (EquippedWeapon->GetSlotIndex() == 5) return;
-	ExchangeInventoryItems(EquippedWeapon->GetSlotIndex(), 5);
+	if (EquippedWeapon == nullptr || EquippedWeapon->GetSlotIndex() == SlotIndex) return;
+	ExchangeInventoryItems(EquippedWeapon->GetSlotIndex(), SlotIndex);
 }
 
 void AShooterCharacter::ExchangeInventoryItems(int32 CurrentItemIndex, int32 NewItemIndex)
 {
 	const bool bCanExchangeItems = 
 		(CurrentItemIndex != NewItemIndex) &&
-		(NewItemIndex < Inventory.Num()) &&
+		(InventoryComponent->GetItem(NewItemIndex) != nullptr) &&
 		(CombatState == ECombatState::ECS_Unoccupied || CombatState == ECombatState::ECS_Equipping);
 
 	if (bCanExchangeItems)
@@ -1086,7 +1492,8 @@ void AShooterCharacter::ExchangeInventoryItems(int32 CurrentItemIndex, int32 New
 		}
 
 		auto OldEquippedWeapon = EquippedWeapon;
-		auto NewWeapon = Cast<AWeapon>(Inventory[NewItemIndex]);
+		auto NewWeapon = Cast<AWeapon>(InventoryComponent->GetItem(NewItemIndex));
+		if (NewWeapon == nullptr) return;
 		EquipWeapon(NewWeapon);
 
 		OldEquippedWeapon->SetItemState(EItemState::EIS_PickedUp);
@@ -1103,36 +1510,29 @@ void AShooterCharacter::ExchangeInventoryItems(int32 CurrentItemIndex, int32 New
 	}
 }
 
-int32 AShooterCharacter::GetEmptyInventorySlot()
-{
-	for (int32 i = 0; i < Inventory.Num(); i++)
-	{
-		if (Inventory[i] == nullptr)
-		{
-			return i;
-		}
-	}
-	if (Inventory.Num() < INVENTORY_CAPACITY)
-	{
-		return Inventory.Num();
-	}
-	
-	return -1; // Inventory is full!
-}
-
 void AShooterCharacter::HighlightInventorySlot()
 {
-	const int32 EmptySlot{ GetEmptyInventorySlot() };
-	HighlightIconDelegate.Broadcast(EmptySlot, true);
+	const int32 EmptySlot{ InventoryComponent->GetFirstFreeSlot() };
+	InventoryComponent->QueueHighlightNotify(EmptySlot, true);
 	HighlightedSlot = EmptySlot;
 }
 
 void AShooterCharacter::UnHighlightInventorySlot()
 {
-	HighlightIconDelegate.Broadcast(HighlightedSlot, false);
+	InventoryComponent->QueueHighlightNotify(HighlightedSlot, false);
 	HighlightedSlot = -1;
 }
 
+void AShooterCharacter::OnInventoryEquipItem(int32 CurrentSlotIndex, int32 NewSlotIndex)
+{
+	EquipItemDelegate.Broadcast(CurrentSlotIndex, NewSlotIndex);
+}
+
+void AShooterCharacter::OnInventoryHighlightIcon(int32 SlotIndex, bool bStartAnimation)
+{
+	HighlightIconDelegate.Broadcast(SlotIndex, bStartAnimation);
+}
+
 void AShooterCharacter::Stun()
 {
 	if (Health <= 0.f) return;
@@ -1148,19 +1548,20 @@ void AShooterCharacter::Stun()
 
 EPhysicalSurface AShooterCharacter::GetSurfaceType()
 {
-	FHitResult HitResult;
-	const FVector Start{ GetActorLocation() };
-	const FVector End{ Start + FVector(0.f, 0.f, -400.f) };
-	FCollisionQueryParams QueryParams;
-	QueryParams.bReturnPhysicalMaterial = true;
+	return USurfaceSubsystem::GetFloorSurface(this, FloorSurfaceCache);
+}
 
-	GetWorld()->LineTraceSingleByChannel(
-		HitResult,
-		Start,
-		End,
-		ECollisionChannel::ECC_Visibility,
-		QueryParams);
-	return UPhysicalMaterial::DetermineSurfaceType(HitResult.PhysMaterial.Get());
+void AShooterCharacter::PlayFootstepSound()
+{
+	const USurfaceSubsystem* Surfaces = USurfaceSubsystem::Get(this);
+	if (Surfaces == nullptr) return;
+
+	const FSurfaceEffectsTable* Effects = Surfaces->GetSurfaceEffects(GetSurfaceType());
+	if (Effects && Effects->FootstepSound)
+	{
+		const FVector FootLocation{ GetActorLocation() - FVector(0.f, 0.f, GetCapsuleComponent()->GetScaledCapsuleHalfHeight()) };
+		UGameplayStatics::PlaySoundAtLocation(this, Effects->FootstepSound, FootLocation);
+	}
 }
 
 void AShooterCharacter::EndStun()
@@ -1194,6 +1595,9 @@ void AShooterCharacter::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
+	// Fire any automatic shots that came due since last frame
+	UpdateAutoFire();
+	TrackFireVoices(0);
 	// Handle interpolation for zoom when aiming
 	CameraInterpZoom(DeltaTime);
 	// Change look sensitivity based on aiming
@@ -1243,18 +1647,18 @@ void AShooterCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputCo
 	PlayerInputComponent->BindAction("Crouch", IE_Pressed, this,
 		&AShooterCharacter::CrouchButtonPressed);
 
-	PlayerInputComponent->BindAction("FKey", IE_Pressed, this,
-		&AShooterCharacter::FKeyPressed);
-	PlayerInputComponent->BindAction("1Key", IE_Pressed, this,
-		&AShooterCharacter::OneKeyPressed);
-	PlayerInputComponent->BindAction("2Key", IE_Pressed, this,
-		&AShooterCharacter::TwoKeyPressed);
-	PlayerInputComponent->BindAction("3Key", IE_Pressed, this,
-		&AShooterCharacter::ThreeKeyPressed);
-	PlayerInputComponent->BindAction("4Key", IE_Pressed, this,
-		&AShooterCharacter::FourKeyPressed);
-	PlayerInputComponent->BindAction("5Key", IE_Pressed, this,
-		&AShooterCharacter::FiveKeyPressed);
+	PlayerInputComponent->BindAction<FSlotKeyDelegate>("FKey", IE_Pressed, this,
+		&AShooterCharacter::SlotKeyPressed, 0);
+	PlayerInputComponent->BindAction<FSlotKeyDelegate>("1Key", IE_Pressed, this,
+		&AShooterCharacter::SlotKeyPressed, 1);
+	PlayerInputComponent->BindAction<FSlotKeyDelegate>("2Key", IE_Pressed, this,
+		&AShooterCharacter::SlotKeyPressed, 2);
+	PlayerInputComponent->BindAction<FSlotKeyDelegate>("3Key", IE_Pressed, this,
+		&AShooterCharacter::SlotKeyPressed, 3);
+	PlayerInputComponent->BindAction<FSlotKeyDelegate>("4Key", IE_Pressed, this,
+		&AShooterCharacter::SlotKeyPressed, 4);
+	PlayerInputComponent->BindAction<FSlotKeyDelegate>("5Key", IE_Pressed, this,
+		&AShooterCharacter::SlotKeyPressed, 5);
 
 }
 
@@ -1271,33 +1675,32 @@ void AShooterCharacter::FinishReloading()
 	}
 
 	if (EquippedWeapon == nullptr) return;
-	const auto AmmoType{ EquippedWeapon->GetAmmoType() };
+	const int32 AmmoTypeId{ EquippedWeapon->GetAmmoTypeId() };
 
-	// Update the AmmoMap
-	if (AmmoMap.Contains(AmmoType))
+	// Update the carried ammo
+	if (CarriedAmmo.IsValidIndex(AmmoTypeId))
 	{
 		// Amount of ammo the Character is carrying of the EquippedWeapon type
-		int32 CarriedAmmo = AmmoMap[AmmoType];
+		int32& Carried = CarriedAmmo[AmmoTypeId];
 
 		// Space left in the magazine of EquippedWeapon
 		const int32 MagEmptySpace = 
 			EquippedWeapon->GetMagazineCapacity() - 
 			EquippedWeapon->GetAmmo();
 
-		if (MagEmptySpace > CarriedAmmo)
+		if (MagEmptySpace > Carried)
 		{
 			// Reload the magazine with all the ammo we are carrying
-			EquippedWeapon->ReloadAmmo(CarriedAmmo);
-			CarriedAmmo = 0;
-			AmmoMap.Add(AmmoType, CarriedAmmo);
+			EquippedWeapon->ReloadAmmo(Carried);
+			Carried = 0;
 		}
 		else
 		{
 			// fill the magazine
 			EquippedWeapon->ReloadAmmo(MagEmptySpace);
-			CarriedAmmo -= MagEmptySpace;
-			AmmoMap.Add(AmmoType, CarriedAmmo);
+			Carried -= MagEmptySpace;
 		}
+		AmmoChangedDelegate.Broadcast();
 	}
 }
 
@@ -1362,6 +1765,21 @@ FVector AShooterCharacter::GetCameraInterpLocation()
 		+ FVector(0.f, 0.f, CameraInterpElevation);
 }*/
 
+TArray<AItem*> AShooterCharacter::GetInventoryItems() const
+{
+	// Up to the last occupied slot, like the array the Inventory property used to be
+	TArray<AItem*> Items;
+	for (int32 SlotIndex = 0; SlotIndex < InventoryComponent->GetCapacity(); SlotIndex++)
+	{
+		if (AItem* Item = InventoryComponent->GetItem(SlotIndex))
+		{
+			Items.SetNum(SlotIndex + 1);
+			Items[SlotIndex] = Item;
+		}
+	}
+	return Items;
+}
+
 void AShooterCharacter::GetPickupItem(AItem* Item)
 {
 	Item->PlayEquipSound();
@@ -1369,10 +1787,17 @@ void AShooterCharacter::GetPickupItem(AItem* Item)
 	auto Weapon = Cast<AWeapon>(Item);
 	if (Weapon)
 	{
-		if (Inventory.Num() < INVENTORY_CAPACITY)
+		// Stacking needs no free slot, so try it even when the inventory is full
+		bool bStacked{ false };
+		const FInventorySlotHandle Slot{ InventoryComponent->AddItem(Weapon, bStacked) };
+		if (bStacked)
+		{
+			// Merged into the stack already in Slot; this actor isn't needed
+			Weapon->Destroy();
+		}
+		else if (Slot.IsValid())
 		{
-			Weapon->SetSlotIndex(Inventory.Num());
-			Inventory.Add(Weapon);
+			Weapon->SetSlotIndex(Slot.Index);
 			Weapon->SetItemState(EItemState::EIS_PickedUp);
 		}
 		else // Inventory is full! Swap with EquippedWeapon
@@ -5,6 +5,10 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "AmmoType.h"
+#include "InventoryComponent.h"
+#include "AmmoTypeSubsystem.h"
+#include "FireScheduler.h"
+#include "SurfaceSubsystem.h"
 #include "ShooterCharacter.generated.h"
 
 UENUM(BlueprintType)
@@ -33,8 +37,11 @@ struct FInterpLocation
 	int32 ItemCount;
 };
 
-DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FEquipItemDelegate, int32, CurrentSlotIndex, int32, NewSlotIndex);
-DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FHighlightIconDelegate, int32, SlotIndex, bool, bStartAnimation);
+class AWeapon;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FCrosshairSpreadDelegate, float, CrosshairSpreadMultiplier);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FAmmoChangedDelegate);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FEquippedWeaponDelegate, AWeapon*, NewWeapon);
 
 UCLASS()
 class SHOOTER_API AShooterCharacter : public ACharacter
@@ -45,6 +52,8 @@ public:
 	// Sets default values for this character's properties
 	AShooterCharacter();
 
+	virtual void PostLoad() override;
+
 	// Take combat damage
 	virtual float TakeDamage(
 		float DamageAmount,
@@ -86,8 +95,8 @@ protected:
 	*/
 	void LookUp(float Value);
 
-	/** Called when the Fire Button is pressed */
-	void FireWeapon();
+	/** Fire one shot; ShotTime is when the shot was due, which may be earlier in the frame */
+	void FireWeapon(double ShotTime, bool bFirstShot);
 
 	bool GetBeamEndLocation(const FVector& MuzzleSocketLocation, FHitResult& OutHitResult);
 
@@ -105,13 +114,20 @@ protected:
 	void FireButtonPressed();
 	void FireButtonReleased();
 
-	void StartFireTimer();
+	void StartFireTimer(double ShotTime);
 
-	UFUNCTION()
-	void AutoFireReset();
+	/** Called when the fire interval after ShotTime has elapsed */
+	void AutoFireReset(double ShotTime);
+
+	/** Fire every automatic shot that came due this frame */
+	void UpdateAutoFire();
 
 	/** Line trace for items under the crosshairs */
-	bool TraceUnderCrosshairs(FHitResult& OutHitResult, FVector& OutHitLocation);
+	bool TraceUnderCrosshairs(
+		FHitResult& OutHitResult,
+		FVector& OutHitLocation,
+		ECollisionChannel TraceChannel = ECollisionChannel::ECC_Visibility,
+		float TraceDistance = 50'000.f);
 
 	/** Trace for items if OverlappedItemCount > 0 */
 	void TraceForItems();
@@ -131,16 +147,32 @@ protected:
 	/** Drops currently equipped Weapon and Equips TraceHitItem */
 	void SwapWeapon(AWeapon* WeaponToSwap);
 
-	/** Initialize the Ammo Map with ammo values */
-	void InitializeAmmoMap();
+	/** Size CarriedAmmo for the registered ammo types and give each its starting ammo */
+	void InitializeCarriedAmmo();
 
 	/** Check to make sure our weapon has ammo */
 	bool WeaponHasAmmo();
 
 	/** FireWeapon functions */
 	void PlayFireSound();
-	void SendBullet();
-	void PlayGunfireMontage();
+
+	/** Stop the automatic fire loop and play its tail */
+	void StopFireLoop();
+	void SendBullet(double ShotTime);
+
+	/**
+	* Apply FirstHit, then follow the bullet through every surface the EquippedWeapon can penetrate
+	* @return Where the bullet's beam should end
+	*/
+	FVector ProcessBulletHits(const FVector& TraceStart, const FHitResult& FirstHit);
+
+	/** Bullet hit interface, damage and impact particles for one hit */
+	void ApplyBulletHit(const FHitResult& HitResult, float DamageScale);
+
+	/** Impact sound and particles for a hit on something without a BulletHitInterface */
+	void SpawnSurfaceImpact(const FHitResult& HitResult);
+	/** Kick the recoil spring and play HipFireMontage; see bHipFireMontageEveryShot */
+	void PlayGunfireMontage(bool bFirstShot);
 
 	/** Bound to the R key and Gamepad Face Button Left */
 	void ReloadButtonPressed();
@@ -173,22 +205,30 @@ protected:
 
 	void InitializeInterpLocations();
 
-	void FKeyPressed();
-	void OneKeyPressed();
-	void TwoKeyPressed();
-	void ThreeKeyPressed();
-	void FourKeyPressed();
-	void FiveKeyPressed();
+	/** Bound to the FKey and 1Key-5Key actions */
+	void SlotKeyPressed(int32 SlotIndex);
 
 	void ExchangeInventoryItems(int32 CurrentItemIndex, int32 NewItemIndex);
 
-	int32 GetEmptyInventorySlot();
-
 	void HighlightInventorySlot();
 
+	/** Forward the Inventory's batched notifications to our own delegates */
+	UFUNCTION()
+	void OnInventoryEquipItem(int32 CurrentSlotIndex, int32 NewSlotIndex);
+
+	UFUNCTION()
+	void OnInventoryHighlightIcon(int32 SlotIndex, bool bStartAnimation);
+
 	UFUNCTION(BlueprintCallable)
 	EPhysicalSurface GetSurfaceType();
 
+	/**
+	* Footstep sound for the surface underfoot, from the surface effects table.
+	* Call it from the AnimBP footstep notifies in place of their GetSurfaceType sound switch
+	*/
+	UFUNCTION(BlueprintCallable)
+	void PlayFootstepSound();
+
 	UFUNCTION(BlueprintCallable)
 	void EndStun();
 
@@ -258,17 +298,39 @@ private:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"), meta = (ClampMin = "0.0", ClampMax = "1.0", UIMin = "0.0", UIMax = "1.0"))
 	float MouseAimingLookUpRate;
 
+	/** Plays the EquippedWeapon's fire loop and tail */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	class UAudioComponent* FireAudioComponent;
+
+	/** True while FireAudioComponent is playing a fire loop */
+	bool bFireLoopPlaying;
+
+	/** Tail for the loop that is playing; the weapon may have changed by the time it stops */
+	UPROPERTY()
+	class USoundCue* FireLoopTailSound;
+
 	/** Montage for firing the weapon */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	class UAnimMontage* HipFireMontage;
 
+	/**
+	* Restart HipFireMontage on every shot, not just the first of a burst.
+	* Leave on until the AnimBP's additive recoil reads UShooterAnimInstance::RecoilAlpha;
+	* without it, later shots of a burst have no recoil pose.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	bool bHipFireMontageEveryShot;
+
 	/** Particles spawned upon bullet impact */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	UParticleSystem* ImpactParticles;
 
-	/** Smoke trail for bullets */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
-	UParticleSystem* BeamParticles;
+	/** Replaced by the weapon table's TracerStyle; still loaded so PostLoad can point at what to move over */
+	UPROPERTY()
+	UParticleSystem* BeamParticles_DEPRECATED;
+
+	/** Floor component and surface found by the last surface query */
+	FFloorSurfaceCache FloorSurfaceCache;
 
 	/** True when aiming */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
@@ -309,24 +371,45 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Crosshairs, meta = (AllowPrivateAccess = "true"))
 	float CrosshairShootingFactor;
 
+	/** Spread last sent through CrosshairSpreadDelegate */
+	float BroadcastCrosshairSpread;
+
+	/** How far the spread must move before the HUD is told */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Crosshairs, meta = (AllowPrivateAccess = "true"))
+	float CrosshairSpreadTolerance;
+
 	/** Left mouse button or right console trigger pressed */
 	bool bFireButtonPressed;
 
 	/** True when we can fire. False when waiting for the timer */
 	bool bShouldFire;
 
-	/** Sets a timer between gunshots */
-	FTimerHandle AutoFireTimer;
+	/** Schedules automatic fire between gunshots */
+	FFireScheduler FireScheduler;
+
+	/** Most shots fired in one frame; any further backlog is dropped */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true", ClampMin = "1"))
+	int32 MaxShotsPerFrame;
+
+	/** Frame the cached crosshair trace was done on; shots in the same frame share it */
+	uint64 CrosshairTraceFrame;
+
+	/** Beam end from the crosshair trace on CrosshairTraceFrame */
+	FVector CachedCrosshairBeamLocation;
 
 	/** True if we should trace every frame for items */
 	bool bShouldTraceForItems;
 
+	/** How far from the camera the item trace reaches */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
+	float ItemTraceDistance;
+
 	/** Number of overlapped AItems */
 	int8 OverlappedItemCount;
 
-	/** The AItem we hit last frame */
+	/** Tracks the item under the crosshairs and highlights it */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
-	class AItem* TraceHitItemLastFrame;
+	class UItemFocusComponent* ItemFocus;
 
 	/** Currently equipped Weapon */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
@@ -338,7 +421,7 @@ private:
 
 	/** The item currently hit by our trace in TraceForItems (could be null) */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
-	AItem* TraceHitItem;
+	class AItem* TraceHitItem;
 
 	/** Distance outward from the camera for the interp destination */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
@@ -348,17 +431,9 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
 	float CameraInterpElevation;
 
-	/** Map to keep track of ammo of the different ammo types */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
-	TMap<EAmmoType, int32> AmmoMap;
-
-	/** Starting amount of 9mm ammo */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Items, meta = (AllowPrivateAccess = "true"))
-	int32 Starting9mmAmmo;
-
-	/** Starting amount of AR ammo */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Items, meta = (AllowPrivateAccess = "true"))
-	int32 StartingARAmmo;
+	/** Ammo carried of each ammo type, indexed by UAmmoTypeSubsystem id; starting amounts come from the ammo type data table */
+	UPROPERTY(VisibleAnywhere, Category = Items, meta = (AllowPrivateAccess = "true"))
+	TArray<int32> CarriedAmmo;
 
 	/** Combat State, can only fire or reload if Unoccupied */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
@@ -462,11 +537,12 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
 	float EquipSoundResetTime;
 
-	/** An array of AItems for our Inventory */
+	/**
+	* Slots holding our AItems. Replaces the Inventory array; Blueprints that read
+	* Inventory use GetInventoryItems, or this component for stack counts
+	*/
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Inventory, meta = (AllowPrivateAccess = "true"))
-	TArray<AItem*> Inventory;
-
-	const int32 INVENTORY_CAPACITY{ 6 };
+	UInventoryComponent* InventoryComponent;
 
 	/** Delegate for sending slot information to InventoryBar when equipping */
 	UPROPERTY(BlueprintAssignable, Category = Delegates, meta = (AllowPrivateAccess = "true"))
@@ -476,6 +552,17 @@ private:
 	UPROPERTY(BlueprintAssignable, Category = Delegates, meta = (AllowPrivateAccess = "true"))
 	FHighlightIconDelegate HighlightIconDelegate;
 
+	/** HUD pushes: only broadcast when the value actually changes */
+	UPROPERTY(BlueprintAssignable, Category = Delegates, meta = (AllowPrivateAccess = "true"))
+	FCrosshairSpreadDelegate CrosshairSpreadDelegate;
+
+	/** Magazine or carried ammo changed */
+	UPROPERTY(BlueprintAssignable, Category = Delegates, meta = (AllowPrivateAccess = "true"))
+	FAmmoChangedDelegate AmmoChangedDelegate;
+
+	UPROPERTY(BlueprintAssignable, Category = Delegates, meta = (AllowPrivateAccess = "true"))
+	FEquippedWeaponDelegate EquippedWeaponDelegate;
+
 	/** The index for the currently highlighted slot */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Inventory, meta = (AllowPrivateAccess = "true"))
 	int32 HighlightedSlot;
@@ -539,6 +626,10 @@ public:
 
 	void GetPickupItem(AItem* Item);
 
+	/** Item in each inventory slot, indexed by SlotIndex; null for free slots before the last item */
+	UFUNCTION(BlueprintPure, Category = Inventory)
+	TArray<AItem*> GetInventoryItems() const;
+
 	FORCEINLINE ECombatState GetCombatState() const { return CombatState; }
 	FORCEINLINE bool GetCrouching() const { return bCrouching; }
 	FInterpLocation GetInterpLocation(int32 Index);
@@ -557,9 +648,64 @@ public:
 	void UnHighlightInventorySlot();
 
 	FORCEINLINE AWeapon* GetEquippedWeapon() const { return EquippedWeapon; }
+	FORCEINLINE FCrosshairSpreadDelegate& GetCrosshairSpreadDelegate() { return CrosshairSpreadDelegate; }
+	FORCEINLINE FAmmoChangedDelegate& GetAmmoChangedDelegate() { return AmmoChangedDelegate; }
+	FORCEINLINE FEquippedWeaponDelegate& GetEquippedWeaponDelegate() { return EquippedWeaponDelegate; }
 	FORCEINLINE USoundCue* GetMeleeImpactSound() const { return MeleeImpactSound; }
 	FORCEINLINE UParticleSystem* GetBloodParticles() const { return BloodParticles; }
 
 	void Stun();
 	FORCEINLINE float GetStunChance() const { return StunChance; }
+
+	/** Ammo carried of the ammo type with this id */
+	UFUNCTION(BlueprintPure, Category = Items)
+	int32 GetCarriedAmmo(int32 AmmoTypeId) const;
+
+	UFUNCTION(BlueprintPure, Category = Items)
+	int32 GetCarriedAmmoOfType(EAmmoType AmmoType) const;
+
+	/** Carried ammo of the EAmmoType types, for Blueprints that read the old AmmoMap property */
+	UFUNCTION(BlueprintPure, Category = Items)
+	TMap<EAmmoType, int32> GetAmmoMap() const;
+
+	/** Save transform, health, carried ammo and inventory; inventory items are saved by name */
+	void CaptureSnapshot(struct FPlayerSnapshot& Snapshot) const;
+
+	/**
+	* Return to a saved state
+	* @param InventoryItems  Item for each of Snapshot's inventory slots, already restored; null where missing
+	*/
+	void RestoreSnapshot(const struct FPlayerSnapshot& Snapshot, const TArray<AItem*>& InventoryItems);
+
+	/**
+	* Trace ECC_Weapon. Enemies only block it with their capsule, so a capsule hit
+	* is confirmed against the enemy's physics asset before it counts
+	*/
+	static bool WeaponTrace(
+		const UWorld* World,
+		FHitResult& OutHitResult,
+		const FVector& Start,
+		const FVector& End,
+		FCollisionQueryParams& QueryParams);
+
+	/**
+	* Compare a WeaponTrace result with the Visibility trace weapons used before, which hit the enemy meshes directly
+	* @return False, describing the difference in OutMismatch, if either hit an enemy and they disagree on the enemy or bone
+	*/
+	static bool CheckHitZoneParity(
+		const UWorld* World,
+		const FHitResult& WeaponHit,
+		const FVector& Start,
+		const FVector& End,
+		const FCollisionQueryParams& QueryParams,
+		FString& OutMismatch);
+
+private:
+	/** WeaponTrace without the shooter.VerifyWeaponTraces check */
+	static bool TraceWeaponChannel(
+		const UWorld* World,
+		FHitResult& OutHitResult,
+		const FVector& Start,
+		const FVector& End,
+		FCollisionQueryParams& QueryParams);
 };
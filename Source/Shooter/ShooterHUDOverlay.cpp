@@ -0,0 +1,114 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterHUDOverlay.h"
+#include "Components/Image.h"
+#include "Components/TextBlock.h"
+#include "Engine/Texture2D.h"
+#include "ShooterCharacter.h"
+#include "Weapon.h"
+#include "Shooter.h"
+
+DECLARE_CYCLE_STAT(TEXT("HUD Push Updates"), STAT_HUDPushUpdates, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("HUD Updates Pushed"), STAT_HUDUpdatesPushed, STATGROUP_Shooter);
+
+void UShooterHUDOverlay::BindCharacter(AShooterCharacter* Character)
+{
+	if (BoundCharacter.Get() == Character) return;
+	UnbindCharacter();
+
+	BoundCharacter = Character;
+	if (Character == nullptr) return;
+
+	Character->GetCrosshairSpreadDelegate().AddDynamic(this, &UShooterHUDOverlay::OnCrosshairSpreadChanged);
+	Character->GetAmmoChangedDelegate().AddDynamic(this, &UShooterHUDOverlay::OnAmmoChanged);
+	Character->GetEquippedWeaponDelegate().AddDynamic(this, &UShooterHUDOverlay::OnEquippedWeaponChanged);
+
+	// Show everything once; after this only changes come through
+	OnEquippedWeaponChanged(Character->GetEquippedWeapon());
+	OnCrosshairSpreadChanged(Character->GetCrosshairSpreadMultiplier());
+}
+
+void UShooterHUDOverlay::NativeDestruct()
+{
+	UnbindCharacter();
+
+	Super::NativeDestruct();
+}
+
+void UShooterHUDOverlay::UnbindCharacter()
+{
+	AShooterCharacter* Character = BoundCharacter.Get();
+	if (Character)
+	{
+		Character->GetCrosshairSpreadDelegate().RemoveDynamic(this, &UShooterHUDOverlay::OnCrosshairSpreadChanged);
+		Character->GetAmmoChangedDelegate().RemoveDynamic(this, &UShooterHUDOverlay::OnAmmoChanged);
+		Character->GetEquippedWeaponDelegate().RemoveDynamic(this, &UShooterHUDOverlay::OnEquippedWeaponChanged);
+	}
+	BoundCharacter.Reset();
+}
+
+void UShooterHUDOverlay::OnCrosshairSpreadChanged(float SpreadMultiplier)
+{
+	SCOPE_CYCLE_COUNTER(STAT_HUDPushUpdates);
+	INC_DWORD_STAT(STAT_HUDUpdatesPushed);
+
+	// Render translation only invalidates the pieces' transforms, not the layout
+	const float Offset{ CrosshairSpreadMax * SpreadMultiplier };
+	if (CrosshairLeft) CrosshairLeft->SetRenderTranslation(FVector2D(-Offset, 0.f));
+	if (CrosshairRight) CrosshairRight->SetRenderTranslation(FVector2D(Offset, 0.f));
+	if (CrosshairTop) CrosshairTop->SetRenderTranslation(FVector2D(0.f, -Offset));
+	if (CrosshairBottom) CrosshairBottom->SetRenderTranslation(FVector2D(0.f, Offset));
+}
+
+void UShooterHUDOverlay::OnAmmoChanged()
+{
+	SCOPE_CYCLE_COUNTER(STAT_HUDPushUpdates);
+	INC_DWORD_STAT(STAT_HUDUpdatesPushed);
+
+	const AShooterCharacter* Character = BoundCharacter.Get();
+	const AWeapon* Weapon = Character ? Character->GetEquippedWeapon() : nullptr;
+	const int32 WeaponAmmo{ Weapon ? Weapon->GetAmmo() : 0 };
+	const int32 CarriedAmmo{ Weapon ? Character->GetCarriedAmmo(Weapon->GetAmmoTypeId()) : 0 };
+
+	if (WeaponAmmoText && WeaponAmmo != ShownWeaponAmmo)
+	{
+		WeaponAmmoText->SetText(FText::AsNumber(WeaponAmmo));
+	}
+	if (CarriedAmmoText && CarriedAmmo != ShownCarriedAmmo)
+	{
+		CarriedAmmoText->SetText(FText::AsNumber(CarriedAmmo));
+	}
+	ShownWeaponAmmo = WeaponAmmo;
+	ShownCarriedAmmo = CarriedAmmo;
+}
+
+void UShooterHUDOverlay::OnEquippedWeaponChanged(AWeapon* NewWeapon)
+{
+	SCOPE_CYCLE_COUNTER(STAT_HUDPushUpdates);
+	INC_DWORD_STAT(STAT_HUDUpdatesPushed);
+
+	SetImageTexture(CrosshairMiddle, NewWeapon ? NewWeapon->GetCrosshairsMiddle() : nullptr);
+	SetImageTexture(CrosshairLeft, NewWeapon ? NewWeapon->GetCrosshairsLeft() : nullptr);
+	SetImageTexture(CrosshairRight, NewWeapon ? NewWeapon->GetCrosshairsRight() : nullptr);
+	SetImageTexture(CrosshairTop, NewWeapon ? NewWeapon->GetCrosshairsTop() : nullptr);
+	SetImageTexture(CrosshairBottom, NewWeapon ? NewWeapon->GetCrosshairsBottom() : nullptr);
+	SetImageTexture(AmmoIcon, NewWeapon ? NewWeapon->GetAmmoIcon() : nullptr);
+
+	if (WeaponNameText)
+	{
+		WeaponNameText->SetText(NewWeapon ? FText::FromString(NewWeapon->GetItemName()) : FText::GetEmpty());
+	}
+
+	// The new weapon's magazine and ammo type change both counts
+	OnAmmoChanged();
+}
+
+void UShooterHUDOverlay::SetImageTexture(UImage* Image, UTexture2D* Texture)
+{
+	if (Image == nullptr) return;
+
+	// Hide pieces the weapon has no texture for rather than drawing a blank brush
+	Image->SetBrushFromTexture(Texture);
+	Image->SetVisibility(Texture ? ESlateVisibility::HitTestInvisible : ESlateVisibility::Collapsed);
+}
@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "ShooterHUDOverlay.generated.h"
+
+class AShooterCharacter;
+class AWeapon;
+class UImage;
+class UTextBlock;
+
+/**
+ * Native base for the HUD Overlay. Nothing here ticks or uses property bindings:
+ * the character pushes crosshair spread, ammo and weapon changes, and only the
+ * widgets those touch are invalidated, so the overlay can sit in an InvalidationBox.
+ * Every widget is optional; the Blueprint names them to opt in.
+ */
+UCLASS()
+class SHOOTER_API UShooterHUDOverlay : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+	/** Listen to Character's HUD delegates and show its current state */
+	void BindCharacter(AShooterCharacter* Character);
+
+protected:
+	virtual void NativeDestruct() override;
+
+private:
+	void UnbindCharacter();
+
+	UFUNCTION()
+	void OnCrosshairSpreadChanged(float SpreadMultiplier);
+
+	UFUNCTION()
+	void OnAmmoChanged();
+
+	UFUNCTION()
+	void OnEquippedWeaponChanged(AWeapon* NewWeapon);
+
+	static void SetImageTexture(UImage* Image, class UTexture2D* Texture);
+
+	TWeakObjectPtr<AShooterCharacter> BoundCharacter;
+
+	/** Crosshair pieces, moved outwards by the spread */
+	UPROPERTY(meta = (BindWidgetOptional))
+	UImage* CrosshairMiddle;
+
+	UPROPERTY(meta = (BindWidgetOptional))
+	UImage* CrosshairLeft;
+
+	UPROPERTY(meta = (BindWidgetOptional))
+	UImage* CrosshairRight;
+
+	UPROPERTY(meta = (BindWidgetOptional))
+	UImage* CrosshairTop;
+
+	UPROPERTY(meta = (BindWidgetOptional))
+	UImage* CrosshairBottom;
+
+	UPROPERTY(meta = (BindWidgetOptional))
+	UTextBlock* WeaponAmmoText;
+
+	UPROPERTY(meta = (BindWidgetOptional))
+	UTextBlock* CarriedAmmoText;
+
+	UPROPERTY(meta = (BindWidgetOptional))
+	UTextBlock* WeaponNameText;
+
+	UPROPERTY(meta = (BindWidgetOptional))
+	UImage* AmmoIcon;
+
+	/** Pixels each crosshair piece moves out per unit of spread multiplier */
+	UPROPERTY(EditAnywhere, Category = Crosshairs)
+	float CrosshairSpreadMax = 16.f;
+
+	/** Counts on screen, so unchanged text isn't set again */
+	int32 ShownWeaponAmmo = -1;
+	int32 ShownCarriedAmmo = -1;
+};
@@ -0,0 +1,259 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterMemory.h"
+#include "HAL/LowLevelMemStats.h"
+#include "Serialization/ArchiveCountMem.h"
+#include "UObject/UObjectIterator.h"
+#include "Components/StaticMeshComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Blueprint/UserWidget.h"
+#include "Blueprint/WidgetTree.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/SkeletalMesh.h"
+#include "Materials/MaterialInterface.h"
+#include "Item.h"
+#include "Weapon.h"
+#include "Ammo.h"
+#include "Enemy.h"
+#include "Explosive.h"
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+DECLARE_LLM_MEMORY_STAT(TEXT("Shooter Items"), STAT_ShooterItemsLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Shooter Weapons"), STAT_ShooterWeaponsLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Shooter Enemies"), STAT_ShooterEnemiesLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Shooter FX"), STAT_ShooterFXLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Shooter Hit Numbers"), STAT_ShooterHitNumbersLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Shooter AI"), STAT_ShooterAILLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Shooter"), STAT_ShooterSummaryLLM, STATGROUP_LLM);
+#endif
+
+namespace
+{
+	/** Live objects of one class in a census */
+	struct FCensusEntry
+	{
+		const TCHAR* Category{ TEXT("") };
+		int32 Count{ 0 };
+		/** The objects plus their components or widget tree */
+		int64 ObjectBytes{ 0 };
+		/** Meshes and materials the objects use, each counted once per class */
+		int64 AssetBytes{ 0 };
+	};
+
+	/** Keyed by class name */
+	using FCensus = TMap<FString, FCensusEntry>;
+
+	/** Census the next diff compares against */
+	FCensus LastCensus;
+	bool bHasLastCensus{ false };
+
+	int64 GetObjectBytes(UObject* Object)
+	{
+		FArchiveCountMem CountMem(Object);
+		return static_cast<int64>(CountMem.GetMax()) + Object->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+	}
+
+	/** Editor and preview worlds hold objects of the same classes; only the game's count */
+	bool IsGameObject(const UObject* Object)
+	{
+		const UWorld* World = Object->GetWorld();
+		return World && World->IsGameWorld() && !Object->IsPendingKill();
+	}
+
+	const TCHAR* GetActorCategory(const AActor* Actor)
+	{
+		if (Actor->IsA<AWeapon>()) return TEXT("Weapon");
+		if (Actor->IsA<AAmmo>()) return TEXT("Ammo");
+		if (Actor->IsA<AItem>()) return TEXT("Item");
+		if (Actor->IsA<AEnemy>()) return TEXT("Enemy");
+		return TEXT("Explosive");
+	}
+
+	void AddActor(FCensus& Census, TMap<FString, TSet<UObject*>>& Assets, AActor* Actor)
+	{
+		const FString ClassName{ Actor->GetClass()->GetName() };
+		FCensusEntry& Entry = Census.FindOrAdd(ClassName);
+		Entry.Category = GetActorCategory(Actor);
+		++Entry.Count;
+		Entry.ObjectBytes += GetObjectBytes(Actor);
+
+		TSet<UObject*>& ClassAssets = Assets.FindOrAdd(ClassName);
+		for (UActorComponent* Component : Actor->GetComponents())
+		{
+			if (Component == nullptr) continue;
+			Entry.ObjectBytes += GetObjectBytes(Component);
+
+			if (const UStaticMeshComponent* StaticMesh = Cast<UStaticMeshComponent>(Component))
+			{
+				ClassAssets.Add(StaticMesh->GetStaticMesh());
+			}
+			else if (const USkeletalMeshComponent* SkeletalMesh = Cast<USkeletalMeshComponent>(Component))
+			{
+				ClassAssets.Add(SkeletalMesh->SkeletalMesh);
+			}
+			if (const UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Component))
+			{
+				TArray<UMaterialInterface*> Materials;
+				Primitive->GetUsedMaterials(Materials);
+				ClassAssets.Append(Materials);
+			}
+		}
+	}
+
+	template<typename T>
+	void AddActors(FCensus& Census, TMap<FString, TSet<UObject*>>& Assets)
+	{
+		for (TObjectIterator<T> It; It; ++It)
+		{
+			if (IsGameObject(*It))
+			{
+				AddActor(Census, Assets, *It);
+			}
+		}
+	}
+
+	FCensus TakeCensus()
+	{
+		FCensus Census;
+		TMap<FString, TSet<UObject*>> Assets;
+
+		// AItem covers weapons and ammo; the category tells them apart
+		AddActors<AItem>(Census, Assets);
+		AddActors<AEnemy>(Census, Assets);
+		AddActors<AExplosive>(Census, Assets);
+
+		for (TObjectIterator<UUserWidget> It; It; ++It)
+		{
+			UUserWidget* Widget = *It;
+			if (!IsGameObject(Widget)) continue;
+
+			FCensusEntry& Entry = Census.FindOrAdd(Widget->GetClass()->GetName());
+			Entry.Category = TEXT("Widget");
+			++Entry.Count;
+			Entry.ObjectBytes += GetObjectBytes(Widget);
+			if (Widget->WidgetTree)
+			{
+				Widget->WidgetTree->ForEachWidget([&Entry](UWidget* Child)
+				{
+					Entry.ObjectBytes += GetObjectBytes(Child);
+				});
+			}
+		}
+
+		// Shared assets are counted under every class using them, so asset totals don't add up across classes
+		for (TPair<FString, TSet<UObject*>>& ClassAssets : Assets)
+		{
+			FCensusEntry& Entry = Census.FindChecked(ClassAssets.Key);
+			for (UObject* Asset : ClassAssets.Value)
+			{
+				if (Asset)
+				{
+					Entry.AssetBytes += Asset->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+				}
+			}
+		}
+
+		Census.ValueSort([](const FCensusEntry& A, const FCensusEntry& B)
+		{
+			return A.ObjectBytes > B.ObjectBytes;
+		});
+		return Census;
+	}
+
+	double ToKB(int64 Bytes)
+	{
+		return Bytes / 1024.;
+	}
+
+	void LogCensus(const FCensus& Census, FOutputDevice& Ar)
+	{
+		Ar.Logf(TEXT("%-10s %-48s %8s %12s %12s"), TEXT("Category"), TEXT("Class"), TEXT("Count"), TEXT("Object KB"), TEXT("Asset KB"));
+
+		int32 TotalCount{ 0 };
+		int64 TotalObjectBytes{ 0 };
+		for (const TPair<FString, FCensusEntry>& Pair : Census)
+		{
+			const FCensusEntry& Entry = Pair.Value;
+			Ar.Logf(TEXT("%-10s %-48s %8d %12.1f %12.1f"),
+				Entry.Category, *Pair.Key, Entry.Count, ToKB(Entry.ObjectBytes), ToKB(Entry.AssetBytes));
+			TotalCount += Entry.Count;
+			TotalObjectBytes += Entry.ObjectBytes;
+		}
+		Ar.Logf(TEXT("%-10s %-48s %8d %12.1f"), TEXT("Total"), TEXT(""), TotalCount, ToKB(TotalObjectBytes));
+	}
+
+	/** Classes whose count or object memory changed since Before; growing counts are the leak candidates */
+	void LogCensusDiff(const FCensus& Before, const FCensus& After, FOutputDevice& Ar)
+	{
+		TSet<FString> ClassNames;
+		for (const TPair<FString, FCensusEntry>& Pair : Before) ClassNames.Add(Pair.Key);
+		for (const TPair<FString, FCensusEntry>& Pair : After) ClassNames.Add(Pair.Key);
+
+		Ar.Logf(TEXT("%-10s %-48s %8s %8s %12s"), TEXT("Category"), TEXT("Class"), TEXT("Count"), TEXT("Change"), TEXT("Object KB"));
+
+		int32 Changed{ 0 };
+		for (const FString& ClassName : ClassNames)
+		{
+			static const FCensusEntry Empty;
+			const FCensusEntry* BeforeEntry = Before.Find(ClassName);
+			const FCensusEntry* AfterEntry = After.Find(ClassName);
+			const FCensusEntry& Old = BeforeEntry ? *BeforeEntry : Empty;
+			const FCensusEntry& New = AfterEntry ? *AfterEntry : Empty;
+			if (Old.Count == New.Count && Old.ObjectBytes == New.ObjectBytes) continue;
+
+			Ar.Logf(TEXT("%-10s %-48s %8d %+8d %+12.1f"),
+				AfterEntry ? New.Category : Old.Category, *ClassName,
+				New.Count, New.Count - Old.Count, ToKB(New.ObjectBytes - Old.ObjectBytes));
+			++Changed;
+		}
+		if (Changed == 0)
+		{
+			Ar.Logf(TEXT("No change since the last census"));
+		}
+	}
+}
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice CensusCommand(
+	TEXT("shooter.Census"),
+	TEXT("Count live items, weapons, ammo, enemies, explosives and widgets with their object and asset memory.\n")
+	TEXT("shooter.Census diff: show only what changed since the last census, to find objects that leak."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		FCensus Census{ TakeCensus() };
+		if (Args.Num() > 0 && Args[0] == TEXT("diff"))
+		{
+			if (bHasLastCensus)
+			{
+				LogCensusDiff(LastCensus, Census, Ar);
+			}
+			else
+			{
+				Ar.Logf(TEXT("No earlier census to diff against; run shooter.Census first"));
+			}
+		}
+		else
+		{
+			LogCensus(Census, Ar);
+		}
+
+		// Each census becomes the baseline for the next diff
+		LastCensus = MoveTemp(Census);
+		bHasLastCensus = true;
+	}));
+
+void ShooterMemory::RegisterLLMTags()
+{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+	FLowLevelMemTracker& Tracker = FLowLevelMemTracker::Get();
+	const FName SummaryStat{ GET_STATFNAME(STAT_ShooterSummaryLLM) };
+	const int32 Items{ static_cast<int32>(EShooterLLMTag::Items) };
+
+	Tracker.RegisterProjectTag(Items, TEXT("ShooterItems"), GET_STATFNAME(STAT_ShooterItemsLLM), SummaryStat);
+	Tracker.RegisterProjectTag(static_cast<int32>(EShooterLLMTag::Weapons), TEXT("ShooterWeapons"), GET_STATFNAME(STAT_ShooterWeaponsLLM), SummaryStat, Items);
+	Tracker.RegisterProjectTag(static_cast<int32>(EShooterLLMTag::Enemies), TEXT("ShooterEnemies"), GET_STATFNAME(STAT_ShooterEnemiesLLM), SummaryStat);
+	Tracker.RegisterProjectTag(static_cast<int32>(EShooterLLMTag::FX), TEXT("ShooterFX"), GET_STATFNAME(STAT_ShooterFXLLM), SummaryStat);
+	Tracker.RegisterProjectTag(static_cast<int32>(EShooterLLMTag::HitNumbers), TEXT("ShooterHitNumbers"), GET_STATFNAME(STAT_ShooterHitNumbersLLM), SummaryStat);
+	Tracker.RegisterProjectTag(static_cast<int32>(EShooterLLMTag::AI), TEXT("ShooterAI"), GET_STATFNAME(STAT_ShooterAILLM), SummaryStat);
+#endif
+}
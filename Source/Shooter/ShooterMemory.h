@@ -0,0 +1,35 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+
+/** Low-Level Memory Tracker tags for Shooter's systems, taken from the engine's project tag range */
+enum class EShooterLLMTag : int32
+{
+	Items = static_cast<int32>(ELLMTag::ProjectTagStart),
+	/** Child of Items, so weapons also count towards the items total */
+	Weapons,
+	Enemies,
+	FX,
+	HitNumbers,
+	AI,
+};
+
+/** Attribute the allocations in the rest of this scope to a Shooter tag, e.g. SHOOTER_LLM_SCOPE(Enemies) */
+#define SHOOTER_LLM_SCOPE(Tag) LLM_SCOPE(static_cast<ELLMTag>(EShooterLLMTag::Tag))
+
+#else
+
+#define SHOOTER_LLM_SCOPE(Tag)
+
+#endif
+
+namespace ShooterMemory
+{
+	/** Name the Shooter tags in LLM's reports and stats; call once at module startup */
+	void RegisterLLMTags();
+}
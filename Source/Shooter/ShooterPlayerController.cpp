@@ -3,6 +3,8 @@
 
 #include "ShooterPlayerController.h"
 #include "Blueprint/UserWidget.h"
+#include "ShooterHUDOverlay.h"
+#include "ShooterCharacter.h"
 
 AShooterPlayerController::AShooterPlayerController()
 {
@@ -21,6 +23,30 @@ void AShooterPlayerController::BeginPlay()
 		{
 			HUDOverlay->AddToViewport();
 			HUDOverlay->SetVisibility(ESlateVisibility::Visible);
+			BindHUDOverlay();
+
+			if (!HUDOverlay->IsA<UShooterHUDOverlay>())
+			{
+				UE_LOG(LogTemp, Warning, TEXT("HUD Overlay %s isn't reparented to ShooterHUDOverlay, so it still ticks its property bindings"),
+					*HUDOverlayClass->GetName());
+			}
 		}
 	}
+}
+
+void AShooterPlayerController::OnPossess(APawn* InPawn)
+{
+	Super::OnPossess(InPawn);
+
+	BindHUDOverlay();
+}
+
+void AShooterPlayerController::BindHUDOverlay()
+{
+	// A Blueprint-only HUD Overlay keeps working; it just isn't pushed updates
+	UShooterHUDOverlay* ShooterHUDOverlay = Cast<UShooterHUDOverlay>(HUDOverlay);
+	if (ShooterHUDOverlay)
+	{
+		ShooterHUDOverlay->BindCharacter(Cast<AShooterCharacter>(GetPawn()));
+	}
 }
\ No newline at end of file
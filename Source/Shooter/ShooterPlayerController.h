@@ -19,8 +19,12 @@ public:
 protected:
 
 	virtual void BeginPlay() override;
+	virtual void OnPossess(APawn* InPawn) override;
 
 private:
+	/** Point a native HUD Overlay at the possessed character */
+	void BindHUDOverlay();
+
 	/** Reference to the Overall HUD Overlay Blueprint Class */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Widgets, meta = (AllowPrivateAccess = "true"))
 	TSubclassOf<class UUserWidget> HUDOverlayClass;
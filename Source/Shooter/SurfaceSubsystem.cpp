@@ -0,0 +1,110 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SurfaceSubsystem.h"
+#include "Kismet/GameplayStatics.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Shooter.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Floor Surface Queries"), STAT_FloorSurfaceQueries, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Floor Surface Traces"), STAT_FloorSurfaceTraces, STATGROUP_Shooter);
+
+void USurfaceSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	for (int32& Row : SurfaceToRow)
+	{
+		Row = -1;
+	}
+
+	// Path to the Surface Effects Data Table
+	const FString SurfaceEffectsTablePath{ TEXT("DataTable'/Game/_Game/DataTable/SurfaceEffectsDataTable.SurfaceEffectsDataTable'") };
+	UDataTable* SurfaceEffectsTableObject = Cast<UDataTable>(StaticLoadObject(UDataTable::StaticClass(), nullptr, *SurfaceEffectsTablePath));
+	if (SurfaceEffectsTableObject)
+	{
+		SurfaceEffectsTableObject->ForeachRow<FSurfaceEffectsTable>(TEXT("USurfaceSubsystem::Initialize"),
+			[this](const FName& Key, const FSurfaceEffectsTable& Row)
+			{
+				// First row for a surface wins
+				int32& RowIndex = SurfaceToRow[Row.SurfaceType];
+				if (RowIndex == -1)
+				{
+					RowIndex = SurfaceEffects.Add(Row);
+				}
+			});
+	}
+}
+
+USurfaceSubsystem* USurfaceSubsystem::Get(const UObject* WorldContextObject)
+{
+	UGameInstance* GameInstance = UGameplayStatics::GetGameInstance(WorldContextObject);
+	return GameInstance ? GameInstance->GetSubsystem<USurfaceSubsystem>() : nullptr;
+}
+
+EPhysicalSurface USurfaceSubsystem::GetFloorSurface(const ACharacter* Character, FFloorSurfaceCache& Cache)
+{
+	if (Character == nullptr) return EPhysicalSurface::SurfaceType_Default;
+	INC_DWORD_STAT(STAT_FloorSurfaceQueries);
+
+	FCollisionQueryParams QueryParams;
+	QueryParams.bReturnPhysicalMaterial = true;
+
+	const UCharacterMovementComponent* Movement = Character->GetCharacterMovement();
+	if (Movement && Movement->CurrentFloor.IsWalkableFloor())
+	{
+		const FHitResult& FloorHit = Movement->CurrentFloor.HitResult;
+		if (FloorHit.PhysMaterial.IsValid())
+		{
+			return UPhysicalMaterial::DetermineSurfaceType(FloorHit.PhysMaterial.Get());
+		}
+
+		UPrimitiveComponent* FloorComponent = FloorHit.GetComponent();
+		if (FloorComponent)
+		{
+			if (Cache.FloorComponent == FloorComponent)
+			{
+				return Cache.SurfaceType;
+			}
+
+			// New floor: trace just that component, short and straight down through the floor hit
+			INC_DWORD_STAT(STAT_FloorSurfaceTraces);
+			FHitResult HitResult;
+			if (FloorComponent->LineTraceComponent(
+				HitResult,
+				FloorHit.ImpactPoint + FVector(0.f, 0.f, 10.f),
+				FloorHit.ImpactPoint - FVector(0.f, 0.f, 10.f),
+				QueryParams))
+			{
+				Cache.FloorComponent = FloorComponent;
+				Cache.SurfaceType = UPhysicalMaterial::DetermineSurfaceType(HitResult.PhysMaterial.Get());
+				return Cache.SurfaceType;
+			}
+			// Missed (edge of the floor, sloped impact normal); not cached, so the next step tries again
+		}
+	}
+
+	// No floor known (jumping, falling) or the floor trace missed: trace the world below the character
+	INC_DWORD_STAT(STAT_FloorSurfaceTraces);
+	FHitResult HitResult;
+	const FVector Start{ Character->GetActorLocation() };
+	const FVector End{ Start + FVector(0.f, 0.f, -400.f) };
+	Character->GetWorld()->LineTraceSingleByChannel(
+		HitResult,
+		Start,
+		End,
+		ECollisionChannel::ECC_Visibility,
+		QueryParams);
+	return UPhysicalMaterial::DetermineSurfaceType(HitResult.PhysMaterial.Get());
+}
+
+const FSurfaceEffectsTable* USurfaceSubsystem::GetSurfaceEffects(EPhysicalSurface SurfaceType) const
+{
+	int32 RowIndex{ SurfaceToRow[SurfaceType] };
+	if (RowIndex == -1)
+	{
+		RowIndex = SurfaceToRow[EPhysicalSurface::SurfaceType_Default];
+	}
+	return SurfaceEffects.IsValidIndex(RowIndex) ? &SurfaceEffects[RowIndex] : nullptr;
+}
@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Engine/DataTable.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+#include "SurfaceSubsystem.generated.h"
+
+class ACharacter;
+class UPrimitiveComponent;
+
+/** Footstep and impact effects for one surface type */
+USTRUCT(BlueprintType)
+struct FSurfaceEffectsTable : public FTableRowBase
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TEnumAsByte<EPhysicalSurface> SurfaceType = EPhysicalSurface::SurfaceType_Default;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	class USoundCue* FootstepSound = nullptr;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	class USoundCue* ImpactSound = nullptr;
+
+	/** Null to use the shooter's own ImpactParticles */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	class UParticleSystem* ImpactParticles = nullptr;
+};
+
+/** Surface last found under a character, kept by the character between queries */
+struct FFloorSurfaceCache
+{
+	TWeakObjectPtr<UPrimitiveComponent> FloorComponent;
+	EPhysicalSurface SurfaceType = EPhysicalSurface::SurfaceType_Default;
+};
+
+/**
+ * Answers "what surface is this" for footsteps and bullet impacts.
+ * Floor queries read CharacterMovement's current floor; effects come from the surface effects data table.
+ */
+UCLASS()
+class SHOOTER_API USurfaceSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	static USurfaceSubsystem* Get(const UObject* WorldContextObject);
+
+	/**
+	* Surface the character stands on. Only traces when the movement component has no floor,
+	* or once per floor component when the floor hit carries no physical material.
+	* A floor trace that misses isn't cached
+	*/
+	static EPhysicalSurface GetFloorSurface(const ACharacter* Character, FFloorSurfaceCache& Cache);
+
+	/** Effects for SurfaceType, falling back to the Default surface row. Null if neither has a row */
+	const FSurfaceEffectsTable* GetSurfaceEffects(EPhysicalSurface SurfaceType) const;
+
+private:
+	UPROPERTY()
+	TArray<FSurfaceEffectsTable> SurfaceEffects;
+
+	/** Index into SurfaceEffects for each surface type, -1 if the table has no row for it */
+	int32 SurfaceToRow[EPhysicalSurface::SurfaceType_Max];
+};
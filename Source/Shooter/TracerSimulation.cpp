@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TracerSimulation.h"
+
+void FTracerSimulation::AddTracer(const FVector& Start, const FVector& End, float SpawnTime, const FTracerStyle& Style)
+{
+	Tracers.Add({ Start, End, SpawnTime, Style });
+}
+
+void FTracerSimulation::RemoveExpired(float Now)
+{
+	for (int32 i = Tracers.Num() - 1; i >= 0; i--)
+	{
+		if (IsExpired(Tracers[i], Now))
+		{
+			Tracers.RemoveAtSwap(i, 1, false);
+		}
+	}
+}
+
+bool FTracerSimulation::GetSegment(const FTracer& Tracer, float Now, FVector& OutTail, FVector& OutHead)
+{
+	const float Age{ Now - Tracer.SpawnTime };
+	if (Age < 0.f || IsExpired(Tracer, Now)) return false;
+
+	if (Tracer.Style.Speed <= 0.f)
+	{
+		OutTail = Tracer.Start;
+		OutHead = Tracer.End;
+		return true;
+	}
+
+	const FVector Path{ Tracer.End - Tracer.Start };
+	const float PathLength{ Path.Size() };
+	if (PathLength <= KINDA_SMALL_NUMBER) return false;
+
+	// Head travels at Speed and stops at End; the tail follows Length behind it
+	const float HeadDistance{ FMath::Min(Tracer.Style.Speed * Age, PathLength) };
+	const float TailDistance{ FMath::Clamp(Tracer.Style.Speed * Age - Tracer.Style.Length, 0.f, PathLength) };
+	const FVector Direction{ Path / PathLength };
+	OutTail = Tracer.Start + Direction * TailDistance;
+	OutHead = Tracer.Start + Direction * HeadDistance;
+	return true;
+}
+
+bool FTracerSimulation::IsExpired(const FTracer& Tracer, float Now)
+{
+	const float Age{ Now - Tracer.SpawnTime };
+	if (Tracer.Style.Speed <= 0.f)
+	{
+		return Age >= Tracer.Style.Lifetime;
+	}
+
+	// Finished once the tail has reached the end
+	const float PathLength{ FVector::Dist(Tracer.Start, Tracer.End) };
+	return Tracer.Style.Speed * Age - Tracer.Style.Length >= PathLength;
+}
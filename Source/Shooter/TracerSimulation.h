@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TracerSimulation.generated.h"
+
+/** How a weapon's tracers look and move */
+USTRUCT(BlueprintType)
+struct FTracerStyle
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FLinearColor Color = FLinearColor(1.f, 0.6f, 0.2f);
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Thickness = 1.5f;
+
+	/** Speed of the tracer's head; 0 draws the whole path at once */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Speed = 20000.f;
+
+	/** Length of the streak behind the head */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Length = 600.f;
+
+	/** How long a tracer with no speed stays up */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Lifetime = 0.05f;
+};
+
+/** One tracer in flight */
+struct FTracer
+{
+	FVector Start;
+	FVector End;
+	float SpawnTime;
+	FTracerStyle Style;
+};
+
+/**
+ * Tracks every tracer in flight and works out the visible segment of each.
+ * Has no rendering or world dependencies, so it runs the same headless.
+ */
+class SHOOTER_API FTracerSimulation
+{
+public:
+	void AddTracer(const FVector& Start, const FVector& End, float SpawnTime, const FTracerStyle& Style);
+
+	/** Drop tracers that have finished by Now */
+	void RemoveExpired(float Now);
+
+	/**
+	* Visible part of Tracer at Now
+	* @return False if none of it is visible yet or any more
+	*/
+	static bool GetSegment(const FTracer& Tracer, float Now, FVector& OutTail, FVector& OutHead);
+
+	static bool IsExpired(const FTracer& Tracer, float Now);
+
+	const TArray<FTracer>& GetTracers() const { return Tracers; }
+
+	void Reset() { Tracers.Reset(); }
+
+private:
+	TArray<FTracer> Tracers;
+};
@@ -0,0 +1,98 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+#include "TracerSimulation.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTracerSegmentTest, "Shooter.Tracer.SegmentFollowsHead",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTracerSegmentTest::RunTest(const FString& Parameters)
+{
+	FTracerStyle Style;
+	Style.Speed = 10000.f;
+	Style.Length = 500.f;
+	const FTracer Tracer{ FVector::ZeroVector, FVector(2000.f, 0.f, 0.f), 1.f, Style };
+
+	FVector Tail;
+	FVector Head;
+	TestFalse(TEXT("Not visible before it spawns"), FTracerSimulation::GetSegment(Tracer, 0.9f, Tail, Head));
+
+	// Head is 300 out, tail hasn't left the muzzle
+	TestTrue(TEXT("Visible just after spawning"), FTracerSimulation::GetSegment(Tracer, 1.03f, Tail, Head));
+	TestEqual(TEXT("Tail held at the start"), Tail, FVector::ZeroVector, 0.1f);
+	TestEqual(TEXT("Head at Speed * Age"), Head, FVector(300.f, 0.f, 0.f), 0.1f);
+
+	TestTrue(TEXT("Visible in flight"), FTracerSimulation::GetSegment(Tracer, 1.1f, Tail, Head));
+	TestEqual(TEXT("Tail Length behind the head"), Tail, FVector(500.f, 0.f, 0.f), 0.1f);
+	TestEqual(TEXT("Head in flight"), Head, FVector(1000.f, 0.f, 0.f), 0.1f);
+
+	// Head has reached End and waits there while the tail catches up
+	TestTrue(TEXT("Visible while the tail catches up"), FTracerSimulation::GetSegment(Tracer, 1.22f, Tail, Head));
+	TestEqual(TEXT("Tail still moving"), Tail, FVector(1700.f, 0.f, 0.f), 0.1f);
+	TestEqual(TEXT("Head stopped at End"), Head, FVector(2000.f, 0.f, 0.f), 0.1f);
+
+	TestFalse(TEXT("Not expired before the tail reaches End"), FTracerSimulation::IsExpired(Tracer, 1.24f));
+	TestTrue(TEXT("Expired once the tail reaches End"), FTracerSimulation::IsExpired(Tracer, 1.25f));
+	TestFalse(TEXT("Not visible once expired"), FTracerSimulation::GetSegment(Tracer, 1.25f, Tail, Head));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTracerInstantTest, "Shooter.Tracer.InstantTracerUsesLifetime",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTracerInstantTest::RunTest(const FString& Parameters)
+{
+	FTracerStyle Style;
+	Style.Speed = 0.f;
+	Style.Lifetime = 0.05f;
+	const FTracer Tracer{ FVector::ZeroVector, FVector(0.f, 3000.f, 0.f), 2.f, Style };
+
+	FVector Tail;
+	FVector Head;
+	TestTrue(TEXT("Visible when spawned"), FTracerSimulation::GetSegment(Tracer, 2.f, Tail, Head));
+	TestEqual(TEXT("Tail at Start"), Tail, Tracer.Start, 0.1f);
+	TestEqual(TEXT("Head at End"), Head, Tracer.End, 0.1f);
+
+	TestTrue(TEXT("Whole path for its lifetime"), FTracerSimulation::GetSegment(Tracer, 2.04f, Tail, Head));
+	TestTrue(TEXT("Expired after its lifetime"), FTracerSimulation::IsExpired(Tracer, 2.06f));
+	TestFalse(TEXT("Not visible after its lifetime"), FTracerSimulation::GetSegment(Tracer, 2.06f, Tail, Head));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTracerRemoveExpiredTest, "Shooter.Tracer.RemoveExpiredKeepsLiveTracers",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTracerRemoveExpiredTest::RunTest(const FString& Parameters)
+{
+	FTracerStyle Style;
+	Style.Speed = 10000.f;
+	Style.Length = 500.f;
+
+	// Each finishes 0.25 s after it spawns
+	FTracerSimulation Simulation;
+	Simulation.AddTracer(FVector::ZeroVector, FVector(2000.f, 0.f, 0.f), 0.f, Style);
+	Simulation.AddTracer(FVector::ZeroVector, FVector(2000.f, 0.f, 0.f), 0.1f, Style);
+	Simulation.AddTracer(FVector::ZeroVector, FVector(2000.f, 0.f, 0.f), 0.2f, Style);
+
+	Simulation.RemoveExpired(0.1f);
+	TestEqual(TEXT("None finished yet"), Simulation.GetTracers().Num(), 3);
+
+	Simulation.RemoveExpired(0.3f);
+	TestEqual(TEXT("First one dropped"), Simulation.GetTracers().Num(), 2);
+	for (const FTracer& Tracer : Simulation.GetTracers())
+	{
+		TestTrue(TEXT("Only finished tracers dropped"), Tracer.SpawnTime > 0.f);
+	}
+
+	Simulation.RemoveExpired(1.f);
+	TestEqual(TEXT("All dropped"), Simulation.GetTracers().Num(), 0);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TracerSubsystem.h"
+#include "Shooter.h"
+#include "Components/LineBatchComponent.h"
+#include "GameFramework/WorldSettings.h"
+#include "ShooterMemory.h"
+
+DECLARE_CYCLE_STAT(TEXT("Tracer Tick"), STAT_TracerTick, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Tracers Drawn"), STAT_TracersDrawn, STATGROUP_Shooter);
+
+void UTracerSubsystem::Deinitialize()
+{
+	Simulation.Reset();
+	if (LineBatcher)
+	{
+		LineBatcher->DestroyComponent();
+		LineBatcher = nullptr;
+	}
+
+	Super::Deinitialize();
+}
+
+UTracerSubsystem* UTracerSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+	return World ? World->GetSubsystem<UTracerSubsystem>() : nullptr;
+}
+
+void UTracerSubsystem::AddTracer(const FVector& Start, const FVector& End, float SpawnTime, const FTracerStyle& Style)
+{
+	UWorld* World = GetWorld();
+	if (World == nullptr || World->GetNetMode() == NM_DedicatedServer) return;
+
+	SHOOTER_LLM_SCOPE(FX);
+
+	if (LineBatcher == nullptr)
+	{
+		LineBatcher = NewObject<ULineBatchComponent>(World->GetWorldSettings());
+		LineBatcher->bCalculateAccurateBounds = false;
+		LineBatcher->RegisterComponentWithWorld(World);
+	}
+
+	Simulation.AddTracer(Start, End, SpawnTime, Style);
+}
+
+void UTracerSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TracerTick);
+
+	const float Now{ GetWorld()->GetTimeSeconds() };
+	Simulation.RemoveExpired(Now);
+
+	// Redraw every tracer this frame; lines drawn with no lifetime stay until the next flush
+	LineBatcher->Flush();
+
+	const TArray<FTracer>& Tracers{ Simulation.GetTracers() };
+	if (Tracers.Num() == 0) return;
+
+	TArray<FBatchedLine> Lines;
+	Lines.Reserve(Tracers.Num());
+	for (const FTracer& Tracer : Tracers)
+	{
+		FVector Tail;
+		FVector Head;
+		if (FTracerSimulation::GetSegment(Tracer, Now, Tail, Head))
+		{
+			Lines.Emplace(Tail, Head, Tracer.Style.Color, 0.f, Tracer.Style.Thickness, SDPG_World);
+		}
+	}
+	LineBatcher->DrawLines(Lines);
+	INC_DWORD_STAT_BY(STAT_TracersDrawn, Lines.Num());
+}
+
+bool UTracerSubsystem::IsTickable() const
+{
+	return LineBatcher != nullptr && !IsTemplate();
+}
+
+TStatId UTracerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTracerSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,40 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "TracerSimulation.h"
+#include "TracerSubsystem.generated.h"
+
+/**
+ * Owns every bullet tracer in the world and draws them all through one
+ * line batch component, so tracers cost no components of their own.
+ */
+UCLASS()
+class SHOOTER_API UTracerSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	static UTracerSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Fire a tracer from Start to End; SpawnTime may be earlier in the frame than now */
+	void AddTracer(const FVector& Start, const FVector& End, float SpawnTime, const FTracerStyle& Style);
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+private:
+	FTracerSimulation Simulation;
+
+	/** Draws the tracers; created with the first tracer */
+	UPROPERTY()
+	class ULineBatchComponent* LineBatcher;
+};
@@ -2,14 +2,26 @@
 
 
 #include "Weapon.h"
+#include "Shooter.h"
+#include "Components/StaticMeshComponent.h"
+#include "AmmoTypeSubsystem.h"
+#include "DroppedWeaponSubsystem.h"
+#include "WorldSnapshot.h"
+#include "ShooterMemory.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Weapon Bone Evaluations Saved"), STAT_WeaponBoneEvalsSaved, STATGROUP_Shooter);
 
 AWeapon::AWeapon() :
-	ThrowWeaponTime(0.7f),
+	ThrowWeaponTime(3.f),
 	bFalling(false),
+	SettleSpeed(5.f),
+	SettleTime(0.25f),
+	SettledTime(0.f),
 	Ammo(30),
 	MagazineCapacity(30),
 	WeaponType(EWeaponType::EWT_SubmachineGun),
 	AmmoType(EAmmoType::EAT_9mm),
+	AmmoTypeId(-1),
 	ReloadMontageSection(FName(TEXT("Reload SMG"))),
 	ClipBoneName(TEXT("smg_clip")),
 	SlideDisplacement(0.f),
@@ -17,29 +29,50 @@ AWeapon::AWeapon() :
 	bMovingSlide(false),
 	MaxSlideDisplacement(4.f),
 	MaxRecoilRotation(20.f),
-	bAutomatic(true)
+	bAutomatic(true),
+	RecoilImpulse(20.f),
+	MaxPenetrations(0)
 {
+	SHOOTER_LLM_SCOPE(Weapons);
 
+	PickupProxyMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("PickupProxyMesh"));
+	PickupProxyMesh->SetupAttachment(GetItemMesh());
+	PickupProxyMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	PickupProxyMesh->SetGenerateOverlapEvents(false);
+	PickupProxyMesh->SetVisibility(false);
 }
 
 void AWeapon::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	// Keep the Weapon upright
+	// Stop simulating once the thrown Weapon has come to rest
 	if (GetItemState() == EItemState::EIS_Falling && bFalling)
 	{
-		const FRotator MeshRotation{ 0.f, GetItemMesh()->GetComponentRotation().Yaw, 0.f };
-		GetItemMesh()->SetWorldRotation(MeshRotation, false, nullptr, ETeleportType::TeleportPhysics);
+		const bool bResting{
+			!GetItemMesh()->RigidBodyIsAwake() ||
+			GetItemMesh()->GetPhysicsLinearVelocity().SizeSquared() < FMath::Square(SettleSpeed) };
+		SettledTime = bResting ? SettledTime + DeltaTime : 0.f;
+		if (SettledTime >= SettleTime)
+		{
+			StopFalling();
+		}
 	}
 	// Update slide on pistol
 	UpdateSlideDisplacement();
+
+	if (GetItemMesh()->bNoSkeletonUpdate)
+	{
+		INC_DWORD_STAT_BY(STAT_WeaponBoneEvalsSaved, GetItemMesh()->GetNumBones());
+	}
 }
 
 void AWeapon::ThrowWeapon()
 {
 	FRotator MeshRotation{ 0.f, GetItemMesh()->GetComponentRotation().Yaw, 0.f };
 	GetItemMesh()->SetWorldRotation(MeshRotation, false, nullptr, ETeleportType::TeleportPhysics);
+	// Physics keeps it upright from here on
+	SetUprightLock(true);
 
 	const FVector MeshForward{ GetItemMesh()->GetForwardVector() };
 	const FVector MeshRight{ GetItemMesh()->GetRightVector() };
@@ -52,6 +85,7 @@ void AWeapon::ThrowWeapon()
 	GetItemMesh()->AddImpulse(ImpulseDirection);
 
 	bFalling = true;
+	SettledTime = 0.f;
 	GetWorldTimerManager().SetTimer(
 		ThrowWeaponTimer, 
 		this, 
@@ -59,17 +93,49 @@ void AWeapon::ThrowWeapon()
 		ThrowWeaponTime);
 
 	EnableGlowMaterial();
+
+	if (UDroppedWeaponSubsystem* DroppedWeapons = UDroppedWeaponSubsystem::Get(this))
+	{
+		DroppedWeapons->RegisterDroppedWeapon(this);
+	}
 }
 
 void AWeapon::StopFalling()
 {
+	if (!bFalling) return;
+
 	bFalling = false;
+	GetWorldTimerManager().ClearTimer(ThrowWeaponTimer);
+	SetUprightLock(false);
+	GetItemMesh()->PutAllRigidBodiesToSleep();
+	// Pickup state turns off physics, leaving the Weapon kinematic where it lies
 	SetItemState(EItemState::EIS_Pickup);
 	StartPulseTimer();
 }
 
+void AWeapon::SetUprightLock(bool bLock)
+{
+	FBodyInstance* BodyInstance = GetItemMesh()->GetBodyInstance();
+	if (BodyInstance == nullptr) return;
+
+	BodyInstance->bLockXRotation = bLock;
+	BodyInstance->bLockYRotation = bLock;
+	BodyInstance->SetDOFLock(bLock ? EDOFMode::SixDOF : EDOFMode::None);
+}
+
+void AWeapon::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UDroppedWeaponSubsystem* DroppedWeapons = UDroppedWeaponSubsystem::Get(this))
+	{
+		DroppedWeapons->UnregisterDroppedWeapon(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void AWeapon::OnConstruction(const FTransform& Transform)
 {
+	SHOOTER_LLM_SCOPE(Weapons);
 	Super::OnConstruction(Transform);
 	const FString WeaponTablePath{ TEXT("DataTable'/Game/_Game/DataTable/WeaponData.WeaponData'") };
 	UDataTable* WeaponTableObject = Cast<UDataTable>(StaticLoadObject(UDataTable::StaticClass(), nullptr, *WeaponTablePath));
@@ -93,6 +159,7 @@ void AWeapon::OnConstruction(const FTransform& Transform)
 		if (WeaponDataRow)
 		{
 			AmmoType = WeaponDataRow->AmmoType;
+			AmmoTypeName = WeaponDataRow->AmmoTypeName;
 			Ammo = WeaponDataRow->WeaponAmmo;
 			MagazineCapacity = WeaponDataRow->MagazingCapacity;
 			SetPickupSound(WeaponDataRow->PickupSound);
@@ -108,7 +175,9 @@ void AWeapon::OnConstruction(const FTransform& Transform)
 			SetMaterialIndex(WeaponDataRow->MaterialIndex);
 			SetClipBoneName(WeaponDataRow->ClipBoneName);
 			SetReloadMontageSection(WeaponDataRow->ReloadMontageSection);
-			GetItemMesh()->SetAnimInstanceClass(WeaponDataRow->AnimBP);
+			WeaponAnimClass = WeaponDataRow->AnimBP;
+			GetItemMesh()->SetAnimInstanceClass(WeaponAnimClass);
+			PickupProxyMesh->SetStaticMesh(WeaponDataRow->PickupMesh);
 			CrosshairsMiddle = WeaponDataRow->CrosshairsMiddle;
 			CrosshairsLeft = WeaponDataRow->CrosshairsLeft;
 			CrosshairsRight = WeaponDataRow->CrosshairsRight;
@@ -117,10 +186,16 @@ void AWeapon::OnConstruction(const FTransform& Transform)
 			AutoFireRate = WeaponDataRow->AutoFireRate;
 			MuzzleFlash = WeaponDataRow->MuzzleFlash;
 			FireSound = WeaponDataRow->FireSound;
+			FireLoopSound = WeaponDataRow->FireLoopSound;
+			FireTailSound = WeaponDataRow->FireTailSound;
+			TracerStyle = WeaponDataRow->TracerStyle;
 			BoneToHide = WeaponDataRow->BoneToHide;
 			bAutomatic = WeaponDataRow->bAutomatic;
 			Damage = WeaponDataRow->Damage;
 			HeadShotDamage = WeaponDataRow->HeadShotDamage;
+			RecoilImpulse = WeaponDataRow->RecoilImpulse;
+			MaxPenetrations = WeaponDataRow->MaxPenetrations;
+			SurfacePenetration = WeaponDataRow->SurfacePenetration;
 		}
 
 		if (GetMaterialInstance())
@@ -128,20 +203,101 @@ void AWeapon::OnConstruction(const FTransform& Transform)
 			SetDynamicMaterialInstance(UMaterialInstanceDynamic::Create(GetMaterialInstance(), this));
 			GetDynamicMaterialInstance()->SetVectorParameterValue(TEXT("FresnelColor"), GetGlowColor());
 			GetItemMesh()->SetMaterial(GetMaterialIndex(), GetDynamicMaterialInstance());
+			PickupProxyMesh->SetMaterial(GetMaterialIndex(), GetDynamicMaterialInstance());
 
 			EnableGlowMaterial();
 		}
 
 	}
+	PickupProxyMesh->SetCustomDepthStencilValue(GetItemMesh()->CustomDepthStencilValue);
 }
 
 void AWeapon::BeginPlay()
 {
+	SHOOTER_LLM_SCOPE(Weapons);
 	Super::BeginPlay();
+	if (UAmmoTypeSubsystem* AmmoTypes = UAmmoTypeSubsystem::Get(this))
+	{
+		AmmoTypeId = AmmoTypes->ResolveAmmoTypeId(AmmoTypeName, AmmoType);
+	}
 	if (BoneToHide != FName(""))
 	{
 		GetItemMesh()->HideBoneByName(BoneToHide, EPhysBodyOp::PBO_None);
 	}
+	if (GetItemMesh()->bNoSkeletonUpdate)
+	{
+		RefreshIdlePose();
+	}
+}
+
+void AWeapon::SetItemProperties(EItemState State)
+{
+	Super::SetItemProperties(State);
+
+	// Weapons that aren't in use don't need their AnimBP or skeleton updated every frame.
+	// Falling weapons keep ticking so the simulated body stays in sync with the mesh.
+	const bool bIdle{ State == EItemState::EIS_Pickup || State == EItemState::EIS_PickedUp };
+	GetItemMesh()->SetComponentTickEnabled(!bIdle);
+	if (bIdle)
+	{
+		RefreshIdlePose();
+	}
+	else
+	{
+		GetItemMesh()->bNoSkeletonUpdate = false;
+	}
+
+	UpdateMeshRepresentation(State);
+
+	// Picked up again, so no longer counts against the dropped weapon budget
+	const bool bDropped{ State == EItemState::EIS_Pickup || State == EItemState::EIS_Falling };
+	if (!bDropped)
+	{
+		if (UDroppedWeaponSubsystem* DroppedWeapons = UDroppedWeaponSubsystem::Get(this))
+		{
+			DroppedWeapons->UnregisterDroppedWeapon(this);
+		}
+	}
+}
+
+void AWeapon::UpdateMeshRepresentation(EItemState State)
+{
+	// Without a proxy mesh the skeletal mesh is used in every state
+	if (PickupProxyMesh->GetStaticMesh() == nullptr) return;
+
+	switch (State)
+	{
+	case EItemState::EIS_Pickup:
+	case EItemState::EIS_Falling:
+		// Draw the proxy; ItemMesh keeps its physics body but has no render state or AnimBP
+		PickupProxyMesh->SetVisibility(true);
+		GetItemMesh()->SetVisibility(false);
+		if (GetItemMesh()->GetAnimInstance())
+		{
+			GetItemMesh()->SetAnimInstanceClass(nullptr);
+		}
+		break;
+	case EItemState::EIS_EquipInterping:
+	case EItemState::EIS_Equipped:
+		// Swap the full skeletal mesh back in
+		PickupProxyMesh->SetVisibility(false);
+		GetItemMesh()->SetVisibility(true);
+		if (GetItemMesh()->GetAnimInstance() == nullptr && WeaponAnimClass)
+		{
+			GetItemMesh()->SetAnimInstanceClass(WeaponAnimClass);
+		}
+		break;
+	case EItemState::EIS_PickedUp:
+		PickupProxyMesh->SetVisibility(false);
+		break;
+	}
+}
+
+void AWeapon::RefreshIdlePose()
+{
+	GetItemMesh()->bNoSkeletonUpdate = false;
+	GetItemMesh()->RefreshBoneTransforms();
+	GetItemMesh()->bNoSkeletonUpdate = true;
 }
 
 void AWeapon::FinishMovingSlide()
@@ -193,3 +349,58 @@ bool AWeapon::ClipIsFull()
 {
 	return Ammo >= MagazineCapacity;
 }
+
+void AWeapon::CaptureSnapshot(FItemSnapshot& Snapshot) const
+{
+	Super::CaptureSnapshot(Snapshot);
+	Snapshot.WeaponAmmo = Ammo;
+}
+
+void AWeapon::RestoreSnapshot(const FItemSnapshot& Snapshot)
+{
+	// Land a thrown weapon first, so its settle timer can't override the restored state
+	StopFalling();
+	Super::RestoreSnapshot(Snapshot);
+	Ammo = FMath::Clamp(Snapshot.WeaponAmmo, 0, MagazineCapacity);
+}
+
+void AWeapon::EnableCustomDepth()
+{
+	Super::EnableCustomDepth();
+	PickupProxyMesh->SetRenderCustomDepth(GetItemMesh()->bRenderCustomDepth);
+}
+
+void AWeapon::DisableCustomDepth()
+{
+	Super::DisableCustomDepth();
+	PickupProxyMesh->SetRenderCustomDepth(GetItemMesh()->bRenderCustomDepth);
+}
+
+const FSurfacePenetration* AWeapon::FindSurfacePenetration(EPhysicalSurface SurfaceType) const
+{
+	return SurfacePenetration.FindByPredicate([SurfaceType](const FSurfacePenetration& Entry)
+		{
+			return Entry.SurfaceType == SurfaceType;
+		});
+}
+
+bool AWeapon::FindPenetrationExit(
+	UPrimitiveComponent* Component,
+	const FVector& Entry,
+	const FVector& Direction,
+	float MaxDepth,
+	const FCollisionQueryParams& QueryParams,
+	FVector& OutExit)
+{
+	// Trace back at the component from MaxDepth inside it to find where the bullet comes out
+	FHitResult ExitHitResult;
+	const bool bExit = Component->LineTraceComponent(
+		ExitHitResult,
+		Entry + Direction * MaxDepth,
+		Entry,
+		QueryParams);
+	if (!bExit || ExitHitResult.bStartPenetrating) return false; // Too thick
+
+	OutExit = ExitHitResult.Location;
+	return true;
+}
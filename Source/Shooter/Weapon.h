@@ -6,9 +6,29 @@
 #include "Item.h"
 #include "AmmoType.h"
 #include "Engine/DataTable.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+#include "TracerSimulation.h"
 #include "WeaponType.h"
 #include "Weapon.generated.h"
 
+/** How far a bullet can travel through one kind of surface */
+USTRUCT(BlueprintType)
+struct FSurfacePenetration
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TEnumAsByte<EPhysicalSurface> SurfaceType = EPhysicalSurface::SurfaceType_Default;
+
+	/** Thickest material the bullet can pass through */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float MaxDepth = 0.f;
+
+	/** Fraction of the bullet's damage lost passing through */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float DamageLoss = 0.5f;
+};
+
 USTRUCT(BlueprintType)
 struct FWeaponDataTable : public FTableRowBase
 {
@@ -17,6 +37,10 @@ struct FWeaponDataTable : public FTableRowBase
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	EAmmoType AmmoType;
 
+	/** Row in the ammo type table; overrides AmmoType when set */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FName AmmoTypeName;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	int32 WeaponAmmo;
 
@@ -80,6 +104,15 @@ struct FWeaponDataTable : public FTableRowBase
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	USoundCue* FireSound;
 
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	USoundCue* FireLoopSound;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	USoundCue* FireTailSound;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FTracerStyle TracerStyle;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	FName BoneToHide;
 
@@ -91,6 +124,19 @@ struct FWeaponDataTable : public FTableRowBase
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	float HeadShotDamage;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float RecoilImpulse = 20.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 MaxPenetrations;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TArray<FSurfacePenetration> SurfacePenetration;
+
+	/** Static mesh made from ItemMesh; drawn while the weapon lies on the ground */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	UStaticMesh* PickupMesh;
 };
 
 /**
@@ -107,6 +153,11 @@ public:
 protected:
 	void StopFalling();
 
+	/** Lock the body's roll and pitch so a thrown weapon lands upright */
+	void SetUprightLock(bool bLock);
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	virtual void OnConstruction(const FTransform& Transform) override;
 
 	virtual void BeginPlay() override;
@@ -114,11 +165,30 @@ protected:
 	void FinishMovingSlide();
 	void UpdateSlideDisplacement();
 
+	/** Override of SetItemProperties so the mesh only animates while in use */
+	virtual void SetItemProperties(EItemState State) override;
+
+	/** Evaluate the pose once for a mesh that isn't animating */
+	void RefreshIdlePose();
+
+	/** Show the static pickup proxy or the full skeletal mesh based on State */
+	void UpdateMeshRepresentation(EItemState State);
+
 private:
 	FTimerHandle ThrowWeaponTimer;
+	/** Longest a thrown weapon may fall before it is stopped wherever it is */
 	float ThrowWeaponTime;
 	bool bFalling;
 
+	/** Speed under which a falling weapon counts as resting */
+	float SettleSpeed;
+
+	/** How long a falling weapon must rest before it is put to sleep */
+	float SettleTime;
+
+	/** How long the falling weapon has been resting */
+	float SettledTime;
+
 	/** Ammo count for this Weapon */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
 	int32 Ammo;
@@ -135,6 +205,13 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
 	EAmmoType AmmoType;
 
+	/** Row in the ammo type table; overrides AmmoType when set */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
+	FName AmmoTypeName;
+
+	/** Registered id for our ammo type, resolved in BeginPlay */
+	int32 AmmoTypeId;
+
 	/** FName for the Reload Montage Section */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
 	FName ReloadMontageSection;
@@ -181,6 +258,18 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = DataTable, meta = (AllowPrivateAccess = "true"))
 	USoundCue* FireSound;
 
+	/** Looping sound played while an automatic weapon keeps firing */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = DataTable, meta = (AllowPrivateAccess = "true"))
+	USoundCue* FireLoopSound;
+
+	/** Sound played when FireLoopSound stops */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = DataTable, meta = (AllowPrivateAccess = "true"))
+	USoundCue* FireTailSound;
+
+	/** Look of this weapon's bullet tracers */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = DataTable, meta = (AllowPrivateAccess = "true"))
+	FTracerStyle TracerStyle;
+
 	/** Name of the bone to hide on the weapon mesh */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = DataTable, meta = (AllowPrivateAccess = "true"))
 	FName BoneToHide;
@@ -228,6 +317,26 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
 	float HeadShotDamage;
 
+	/** Kick given to the character's recoil spring per shot */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
+	float RecoilImpulse;
+
+	/** Most surfaces a bullet can pass through; 0 stops at the first hit */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true", ClampMin = "0"))
+	int32 MaxPenetrations;
+
+	/** Surfaces a bullet can pass through, with their depth and damage loss */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
+	TArray<FSurfacePenetration> SurfacePenetration;
+
+	/** Lightweight stand-in for ItemMesh while the weapon is a pickup */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
+	UStaticMeshComponent* PickupProxyMesh;
+
+	/** AnimBP for ItemMesh; only instanced while the weapon is equipped */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = DataTable, meta = (AllowPrivateAccess = "true"))
+	TSubclassOf<UAnimInstance> WeaponAnimClass;
+
 public:
 	/** Adds an impulse to the Weapon */
 	void ThrowWeapon();
@@ -240,6 +349,7 @@ public:
 
 	FORCEINLINE EWeaponType GetWeaponType() const { return WeaponType; }
 	FORCEINLINE EAmmoType GetAmmoType() const { return AmmoType; }
+	FORCEINLINE int32 GetAmmoTypeId() const { return AmmoTypeId; }
 	FORCEINLINE FName GetReloadMontageSection() const { return ReloadMontageSection; }
 	FORCEINLINE void SetReloadMontageSection(FName Name) { ReloadMontageSection = Name; }
 	FORCEINLINE FName GetClipBoneName() const { return ClipBoneName; }
@@ -247,9 +357,34 @@ public:
 	FORCEINLINE float GetAutoFireRate() const { return AutoFireRate; }
 	FORCEINLINE UParticleSystem* GetMuzzleFlash() const { return MuzzleFlash; }
 	FORCEINLINE USoundCue* GetFireSound() const { return FireSound; }
+	FORCEINLINE USoundCue* GetFireLoopSound() const { return FireLoopSound; }
+	FORCEINLINE USoundCue* GetFireTailSound() const { return FireTailSound; }
+	FORCEINLINE const FTracerStyle& GetTracerStyle() const { return TracerStyle; }
 	FORCEINLINE bool GetAutomatic() const { return bAutomatic; }
 	FORCEINLINE float GetDamage() const { return Damage; }
 	FORCEINLINE float GetHeadShotDamage() const { return HeadShotDamage; }
+	FORCEINLINE int32 GetMaxPenetrations() const { return MaxPenetrations; }
+	FORCEINLINE float GetRecoilImpulse() const { return RecoilImpulse; }
+	FORCEINLINE UTexture2D* GetCrosshairsMiddle() const { return CrosshairsMiddle; }
+	FORCEINLINE UTexture2D* GetCrosshairsLeft() const { return CrosshairsLeft; }
+	FORCEINLINE UTexture2D* GetCrosshairsRight() const { return CrosshairsRight; }
+	FORCEINLINE UTexture2D* GetCrosshairsBottom() const { return CrosshairsBottom; }
+	FORCEINLINE UTexture2D* GetCrosshairsTop() const { return CrosshairsTop; }
+
+	/** Penetration settings for SurfaceType, or null if bullets stop on it */
+	const FSurfacePenetration* FindSurfacePenetration(EPhysicalSurface SurfaceType) const;
+
+	/**
+	* Where a bullet that hit Component at Entry, travelling along Direction, comes out of it
+	* @return False if Component is thicker than MaxDepth there
+	*/
+	static bool FindPenetrationExit(
+		UPrimitiveComponent* Component,
+		const FVector& Entry,
+		const FVector& Direction,
+		float MaxDepth,
+		const FCollisionQueryParams& QueryParams,
+		FVector& OutExit);
 
 	void StartSlideTimer();
 
@@ -258,4 +393,11 @@ public:
 	FORCEINLINE void SetMovingClip(bool Move) { bMovingClip = Move; }
 
 	bool ClipIsFull();
+
+	virtual void EnableCustomDepth() override;
+	virtual void DisableCustomDepth() override;
+
+	/** Adds the magazine to the Item's saved state */
+	virtual void CaptureSnapshot(struct FItemSnapshot& Snapshot) const override;
+	virtual void RestoreSnapshot(const struct FItemSnapshot& Snapshot) override;
 };
@@ -0,0 +1,234 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+#include "EngineUtils.h"
+#include "Engine/Blueprint.h"
+#include "AssetRegistryModule.h"
+#include "Misc/PackageName.h"
+#include "Components/CapsuleComponent.h"
+#include "GameFramework/WorldSettings.h"
+#include "PhysicsEngine/PhysicsAsset.h"
+#include "ShooterCharacter.h"
+#include "Enemy.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	/** The first Blueprint enemy whose mesh has a physics asset; the native AEnemy has no mesh */
+	UClass* FindEnemyBlueprintClass()
+	{
+		IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+		AssetRegistry.SearchAllAssets(true);
+
+		TArray<FAssetData> Blueprints;
+		AssetRegistry.GetAssetsByClass(UBlueprint::StaticClass()->GetFName(), Blueprints, true);
+		const FString EnemyClassPath{ AEnemy::StaticClass()->GetPathName() };
+		for (const FAssetData& Blueprint : Blueprints)
+		{
+			FString NativeParentClassPath;
+			FString GeneratedClassPath;
+			if (!Blueprint.GetTagValue(FBlueprintTags::NativeParentClassPath, NativeParentClassPath) ||
+				FPackageName::ExportTextPathToObjectPath(NativeParentClassPath) != EnemyClassPath ||
+				!Blueprint.GetTagValue(FBlueprintTags::GeneratedClassPath, GeneratedClassPath))
+			{
+				continue;
+			}
+
+			UClass* Class = LoadObject<UClass>(nullptr, *FPackageName::ExportTextPathToObjectPath(GeneratedClassPath));
+			const AEnemy* Enemy = Class ? Cast<AEnemy>(Class->GetDefaultObject()) : nullptr;
+			if (Enemy && Enemy->GetMesh()->GetPhysicsAsset())
+			{
+				return Class;
+			}
+		}
+		return nullptr;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWeaponTraceHitZoneParityTest, "Shooter.WeaponTrace.HitBonesMatchVisibilityTrace",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FWeaponTraceHitZoneParityTest::RunTest(const FString& Parameters)
+{
+	// Needs real enemy meshes and physics assets, so it runs against the level being played
+	UWorld* World = nullptr;
+	for (const FWorldContext& Context : GEngine->GetWorldContexts())
+	{
+		if (Context.WorldType == EWorldType::PIE || Context.WorldType == EWorldType::Game)
+		{
+			World = Context.World();
+			break;
+		}
+	}
+	if (World == nullptr)
+	{
+		AddWarning(TEXT("No game running; start a level with enemies in it to compare hit bones"));
+		return true;
+	}
+
+	int32 Shots{ 0 };
+	for (TActorIterator<AEnemy> It(World); It; ++It)
+	{
+		const AEnemy* Enemy = *It;
+		const UCapsuleComponent* Capsule = Enemy->GetCapsuleComponent();
+		float Radius;
+		float HalfHeight;
+		Capsule->GetScaledCapsuleSize(Radius, HalfHeight);
+		const FVector Center{ Capsule->GetComponentLocation() };
+
+		// From eight sides, on a grid over the capsule: shots into bodies and through the gaps between them
+		for (int32 Side = 0; Side < 8; Side++)
+		{
+			const FVector Forward{ FRotator(0.f, Side * 45.f, 0.f).Vector() };
+			const FVector Right{ FVector::CrossProduct(FVector::UpVector, Forward) };
+			for (int32 Row = -4; Row <= 4; Row++)
+			{
+				for (int32 Column = -3; Column <= 3; Column++)
+				{
+					const FVector Target{ Center + Right * (Radius * Column / 3.f) + FVector::UpVector * (HalfHeight * Row / 4.f) };
+					const FVector Start{ Target - Forward * 1000.f };
+					const FVector End{ Target + Forward * 1000.f };
+
+					FCollisionQueryParams QueryParams;
+					FHitResult WeaponHit;
+					AShooterCharacter::WeaponTrace(World, WeaponHit, Start, End, QueryParams);
+
+					FString Mismatch;
+					if (!AShooterCharacter::CheckHitZoneParity(World, WeaponHit, Start, End, QueryParams, Mismatch))
+					{
+						AddError(FString::Printf(TEXT("Shot at %s from %s: %s"), *Enemy->GetName(), *Start.ToString(), *Mismatch));
+					}
+					++Shots;
+				}
+			}
+		}
+	}
+
+	if (Shots == 0)
+	{
+		AddWarning(TEXT("The running level has no enemies; nothing to compare"));
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWeaponTraceCrowdBenchmark, "Shooter.WeaponTrace.CrowdBenchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FWeaponTraceCrowdBenchmark::RunTest(const FString& Parameters)
+{
+	UClass* EnemyClass = FindEnemyBlueprintClass();
+	if (EnemyClass == nullptr)
+	{
+		AddError(TEXT("No enemy Blueprint with a physics asset to build the crowd from"));
+		return false;
+	}
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	// 100 enemies in a 10 x 10 crowd, shoulder to shoulder, in the reference pose
+	constexpr int32 CrowdWidth{ 10 };
+	constexpr float CrowdSpacing{ 120.f };
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	for (int32 Row = 0; Row < CrowdWidth; Row++)
+	{
+		for (int32 Column = 0; Column < CrowdWidth; Column++)
+		{
+			const FVector Location{
+				(Column - (CrowdWidth - 1) * 0.5f) * CrowdSpacing,
+				(Row - (CrowdWidth - 1) * 0.5f) * CrowdSpacing,
+				0.f };
+			AEnemy* Enemy = World->SpawnActor<AEnemy>(EnemyClass, Location, FRotator(0.f, Row * 37.f + Column * 11.f, 0.f), SpawnParams);
+			if (Enemy)
+			{
+				Enemy->SetupHitCollision();
+			}
+		}
+	}
+
+	// 32 shooters on a ring around the crowd, each firing at random points inside it
+	constexpr int32 NumShooters{ 32 };
+	constexpr int32 ShotsPerShooter{ 200 };
+	constexpr float ShooterDistance{ 2500.f };
+	constexpr float CrowdHalfWidth{ CrowdWidth * CrowdSpacing * 0.5f };
+	FRandomStream Random(40);
+	TArray<TPair<FVector, FVector>> Shots;
+	Shots.Reserve(NumShooters * ShotsPerShooter);
+	for (int32 Shooter = 0; Shooter < NumShooters; Shooter++)
+	{
+		const FVector Muzzle{ FRotator(0.f, Shooter * 360.f / NumShooters, 0.f).Vector() * ShooterDistance + FVector(0.f, 0.f, 60.f) };
+		for (int32 Shot = 0; Shot < ShotsPerShooter; Shot++)
+		{
+			const FVector Aim{
+				Random.FRandRange(-CrowdHalfWidth, CrowdHalfWidth),
+				Random.FRandRange(-CrowdHalfWidth, CrowdHalfWidth),
+				Random.FRandRange(-80.f, 100.f) };
+			Shots.Emplace(Muzzle, Muzzle + (Aim - Muzzle).GetSafeNormal() * ShooterDistance * 2.f);
+		}
+	}
+
+	// Best of several passes each, so a hitch on the machine doesn't decide the result
+	constexpr int32 Passes{ 5 };
+	double WeaponSeconds{ TNumericLimits<double>::Max() };
+	double VisibilitySeconds{ TNumericLimits<double>::Max() };
+	int32 WeaponHits{ 0 };
+	int32 VisibilityHits{ 0 };
+	for (int32 Pass = 0; Pass < Passes; Pass++)
+	{
+		WeaponHits = 0;
+		double PassStart{ FPlatformTime::Seconds() };
+		for (const TPair<FVector, FVector>& Shot : Shots)
+		{
+			FCollisionQueryParams QueryParams;
+			FHitResult HitResult;
+			WeaponHits += AShooterCharacter::WeaponTrace(World, HitResult, Shot.Key, Shot.Value, QueryParams) ? 1 : 0;
+		}
+		WeaponSeconds = FMath::Min(WeaponSeconds, FPlatformTime::Seconds() - PassStart);
+
+		// What weapons traced before ECC_Weapon: Visibility, which the enemy meshes block body by body
+		VisibilityHits = 0;
+		PassStart = FPlatformTime::Seconds();
+		for (const TPair<FVector, FVector>& Shot : Shots)
+		{
+			const FCollisionQueryParams QueryParams;
+			FHitResult HitResult;
+			VisibilityHits += World->LineTraceSingleByChannel(HitResult, Shot.Key, Shot.Value, ECollisionChannel::ECC_Visibility, QueryParams) ? 1 : 0;
+		}
+		VisibilitySeconds = FMath::Min(VisibilitySeconds, FPlatformTime::Seconds() - PassStart);
+	}
+
+	// Both paths have to agree for the timing to mean anything
+	int32 Mismatches{ 0 };
+	for (const TPair<FVector, FVector>& Shot : Shots)
+	{
+		FCollisionQueryParams QueryParams;
+		FHitResult HitResult;
+		AShooterCharacter::WeaponTrace(World, HitResult, Shot.Key, Shot.Value, QueryParams);
+		FString Mismatch;
+		if (!AShooterCharacter::CheckHitZoneParity(World, HitResult, Shot.Key, Shot.Value, FCollisionQueryParams(), Mismatch))
+		{
+			++Mismatches;
+			AddError(FString::Printf(TEXT("Shot from %s: %s"), *Shot.Key.ToString(), *Mismatch));
+		}
+	}
+
+	const double NumShots{ static_cast<double>(Shots.Num()) };
+	AddInfo(FString::Printf(TEXT("%s crowd of %d, %d shots from %d shooters, best of %d passes"),
+		*EnemyClass->GetName(), CrowdWidth * CrowdWidth, Shots.Num(), NumShooters, Passes));
+	AddInfo(FString::Printf(TEXT("Weapon trace (capsule, then physics asset): %.2f us per shot, %d hits"),
+		WeaponSeconds * 1e6 / NumShots, WeaponHits));
+	AddInfo(FString::Printf(TEXT("Visibility trace (physics asset only): %.2f us per shot, %d hits"),
+		VisibilitySeconds * 1e6 / NumShots, VisibilityHits));
+	AddInfo(FString::Printf(TEXT("Weapon trace takes %.2fx the time of the Visibility trace; %d hit bone mismatches"),
+		WeaponSeconds / FMath::Max(VisibilitySeconds, SMALL_NUMBER), Mismatches));
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	return true;
+}
+
+#endif
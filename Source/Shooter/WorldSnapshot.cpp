@@ -0,0 +1,137 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WorldSnapshot.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Misc/Compression.h"
+
+const FGuid FWorldSnapshotVersion::GUID(0x6E1B3A52, 0x4C7F4D0E, 0x9A2B8F31, 0xD5C04E17);
+
+namespace
+{
+	/** 'SNAP' */
+	constexpr uint32 SnapshotMagic{ 0x50414E53 };
+
+	/** Far beyond any real level; a header asking for more is corrupt and isn't allocated for */
+	constexpr int32 MaxUncompressedSize{ 64 * 1024 * 1024 };
+
+	/** Stored uncompressed in front of the payload */
+	struct FSnapshotHeader
+	{
+		uint32 Magic{ SnapshotMagic };
+		int32 Version{ FWorldSnapshotVersion::LatestVersion };
+		int32 UncompressedSize{ 0 };
+
+		friend FArchive& operator<<(FArchive& Ar, FSnapshotHeader& Header)
+		{
+			Ar << Header.Magic << Header.Version << Header.UncompressedSize;
+			return Ar;
+		}
+	};
+}
+
+FArchive& operator<<(FArchive& Ar, FActorSnapshot& Snapshot)
+{
+	Ar << Snapshot.ClassIndex << Snapshot.Name << Snapshot.Location << Snapshot.Rotation;
+	return Ar;
+}
+
+FArchive& operator<<(FArchive& Ar, FItemSnapshot& Snapshot)
+{
+	Ar << Snapshot.Actor << Snapshot.ItemState << Snapshot.ItemRarity << Snapshot.ItemCount << Snapshot.WeaponAmmo;
+	return Ar;
+}
+
+FArchive& operator<<(FArchive& Ar, FEnemySnapshot& Snapshot)
+{
+	Ar << Snapshot.Actor << Snapshot.Health << Snapshot.Target << Snapshot.PatrolPoint << Snapshot.PatrolPoint2;
+	return Ar;
+}
+
+FArchive& operator<<(FArchive& Ar, FPlayerSnapshot& Snapshot)
+{
+	Ar << Snapshot.Location << Snapshot.Rotation << Snapshot.ControlRotation;
+	Ar << Snapshot.Health;
+	Ar << Snapshot.CarriedAmmo;
+	Ar << Snapshot.InventoryItems << Snapshot.StackCounts << Snapshot.EquippedSlot;
+	return Ar;
+}
+
+FArchive& operator<<(FArchive& Ar, FWorldSnapshot& Snapshot)
+{
+	Ar << Snapshot.MapName << Snapshot.ClassPaths;
+	Ar << Snapshot.bHasPlayer;
+	if (Snapshot.bHasPlayer)
+	{
+		Ar << Snapshot.Player;
+	}
+	Ar << Snapshot.Items << Snapshot.Enemies << Snapshot.Explosives;
+	return Ar;
+}
+
+int32 FWorldSnapshot::AddClass(const UClass* Class)
+{
+	if (const int32* Index = ClassIndices.Find(Class))
+	{
+		return *Index;
+	}
+	const int32 Index{ ClassPaths.Add(Class->GetPathName()) };
+	ClassIndices.Add(Class, Index);
+	return Index;
+}
+
+bool FWorldSnapshot::Write(TArray<uint8>& OutBytes)
+{
+	TArray<uint8> Payload;
+	FMemoryWriter PayloadWriter(Payload);
+	PayloadWriter.SetCustomVersion(FWorldSnapshotVersion::GUID, FWorldSnapshotVersion::LatestVersion, TEXT("WorldSnapshot"));
+	PayloadWriter << *this;
+
+	FSnapshotHeader Header;
+	Header.UncompressedSize = Payload.Num();
+
+	OutBytes.Reset();
+	FMemoryWriter Writer(OutBytes);
+	Writer << Header;
+	const int32 HeaderSize{ OutBytes.Num() };
+
+	int32 CompressedSize{ FCompression::CompressMemoryBound(NAME_Zlib, Payload.Num()) };
+	OutBytes.AddUninitialized(CompressedSize);
+	if (!FCompression::CompressMemory(NAME_Zlib, OutBytes.GetData() + HeaderSize, CompressedSize, Payload.GetData(), Payload.Num()))
+	{
+		return false;
+	}
+	OutBytes.SetNum(HeaderSize + CompressedSize, false);
+	return true;
+}
+
+bool FWorldSnapshot::Read(const TArray<uint8>& Bytes)
+{
+	FMemoryReader Reader(Bytes);
+	FSnapshotHeader Header;
+	Reader << Header;
+	if (Reader.IsError() ||
+		Header.Magic != SnapshotMagic ||
+		Header.Version < FWorldSnapshotVersion::Initial ||
+		Header.Version > FWorldSnapshotVersion::LatestVersion ||
+		Header.UncompressedSize < 0 ||
+		Header.UncompressedSize > MaxUncompressedSize)
+	{
+		return false;
+	}
+
+	const int32 HeaderSize{ static_cast<int32>(Reader.Tell()) };
+	TArray<uint8> Payload;
+	Payload.SetNumUninitialized(Header.UncompressedSize);
+	if (!FCompression::UncompressMemory(NAME_Zlib, Payload.GetData(), Payload.Num(), Bytes.GetData() + HeaderSize, Bytes.Num() - HeaderSize))
+	{
+		return false;
+	}
+
+	// Older versions read through the same operators, which check Ar.CustomVer for fields added since
+	FMemoryReader PayloadReader(Payload);
+	PayloadReader.SetCustomVersion(FWorldSnapshotVersion::GUID, Header.Version, TEXT("WorldSnapshot"));
+	PayloadReader << *this;
+	return !PayloadReader.IsError();
+}
@@ -0,0 +1,121 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Snapshot format versions; add new ones above VersionPlusOne */
+struct FWorldSnapshotVersion
+{
+	enum Type
+	{
+		Initial = 1,
+
+		VersionPlusOne,
+		LatestVersion = VersionPlusOne - 1
+	};
+
+	static const FGuid GUID;
+};
+
+/** Where an actor is and how to find or respawn it */
+struct FActorSnapshot
+{
+	/** Index into FWorldSnapshot::ClassPaths */
+	int32 ClassIndex{ INDEX_NONE };
+
+	/** Actor name in its level; placed actors keep theirs across sessions */
+	FName Name;
+
+	FVector Location{ FVector::ZeroVector };
+	FRotator Rotation{ FRotator::ZeroRotator };
+
+	friend FArchive& operator<<(FArchive& Ar, FActorSnapshot& Snapshot);
+};
+
+struct FItemSnapshot
+{
+	FActorSnapshot Actor;
+
+	/** EItemState; in-flight states are saved as Pickup */
+	uint8 ItemState{ 0 };
+
+	/** EItemRarity; only applied to items that have to be spawned */
+	uint8 ItemRarity{ 0 };
+
+	int32 ItemCount{ 0 };
+
+	/** Rounds in the magazine; -1 for items that aren't weapons */
+	int32 WeaponAmmo{ -1 };
+
+	friend FArchive& operator<<(FArchive& Ar, FItemSnapshot& Snapshot);
+};
+
+struct FEnemySnapshot
+{
+	FActorSnapshot Actor;
+
+	float Health{ 0.f };
+
+	/** Blackboard Target; None when not chasing */
+	FName Target;
+
+	/** Blackboard patrol points, in world space */
+	FVector PatrolPoint{ FVector::ZeroVector };
+	FVector PatrolPoint2{ FVector::ZeroVector };
+
+	friend FArchive& operator<<(FArchive& Ar, FEnemySnapshot& Snapshot);
+};
+
+struct FPlayerSnapshot
+{
+	FVector Location{ FVector::ZeroVector };
+	FRotator Rotation{ FRotator::ZeroRotator };
+	FRotator ControlRotation{ FRotator::ZeroRotator };
+
+	float Health{ 0.f };
+
+	/** By ammo type name, so the ammo type table can change between saves */
+	TMap<FName, int32> CarriedAmmo;
+
+	/** Item name in each inventory slot; None for free slots */
+	TArray<FName> InventoryItems;
+	TArray<int32> StackCounts;
+
+	/** -1 when nothing is equipped */
+	int32 EquippedSlot{ INDEX_NONE };
+
+	friend FArchive& operator<<(FArchive& Ar, FPlayerSnapshot& Snapshot);
+};
+
+/** Everything a snapshot restores, in the order it is restored */
+struct FWorldSnapshot
+{
+	/** Level the snapshot was taken in, without the PIE prefix */
+	FString MapName;
+
+	/** Class of each actor record, shared between records of the same class */
+	TArray<FString> ClassPaths;
+
+	bool bHasPlayer{ false };
+	FPlayerSnapshot Player;
+
+	TArray<FItemSnapshot> Items;
+	TArray<FEnemySnapshot> Enemies;
+	TArray<FActorSnapshot> Explosives;
+
+	/** Index of Class in ClassPaths, adding it if new */
+	int32 AddClass(const UClass* Class);
+
+	/** Serialize, compress and prefix the format header */
+	bool Write(TArray<uint8>& OutBytes);
+
+	/** Inverse of Write; false if the data isn't a snapshot or is from a newer version */
+	bool Read(const TArray<uint8>& Bytes);
+
+	friend FArchive& operator<<(FArchive& Ar, FWorldSnapshot& Snapshot);
+
+private:
+	/** Capture-time lookup for AddClass; not serialized */
+	TMap<const UClass*, int32> ClassIndices;
+};
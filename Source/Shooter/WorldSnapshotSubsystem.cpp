@@ -0,0 +1,468 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WorldSnapshotSubsystem.h"
+#include "Kismet/GameplayStatics.h"
+#include "EngineUtils.h"
+#include "Engine/AssetManager.h"
+#include "Async/Async.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+#include "ShooterCharacter.h"
+#include "Item.h"
+#include "Enemy.h"
+#include "Explosive.h"
+#include "ActorStreamingSubsystem.h"
+#include "Shooter.h"
+
+DECLARE_CYCLE_STAT(TEXT("Snapshot Capture"), STAT_SnapshotCapture, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Snapshot Apply"), STAT_SnapshotApply, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Snapshot Actors Spawned"), STAT_SnapshotActorsSpawned, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Snapshot Actors Destroyed"), STAT_SnapshotActorsDestroyed, STATGROUP_Shooter);
+
+static TAutoConsoleVariable<float> CVarAutosaveInterval(
+	TEXT("shooter.AutosaveInterval"),
+	0.f,
+	TEXT("Seconds between autosave snapshots; 0 turns autosave off."));
+
+static FAutoConsoleCommandWithWorldAndArgs SaveSnapshotCommand(
+	TEXT("shooter.SaveSnapshot"),
+	TEXT("shooter.SaveSnapshot [Slot]: save the level to a snapshot slot, Quick by default."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (UWorldSnapshotSubsystem* Snapshots = UWorldSnapshotSubsystem::Get(World))
+		{
+			Snapshots->SaveSnapshot(Args.Num() > 0 ? Args[0] : TEXT("Quick"));
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs LoadSnapshotCommand(
+	TEXT("shooter.LoadSnapshot"),
+	TEXT("shooter.LoadSnapshot [Slot]: restore the level from a snapshot slot, Quick by default."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (UWorldSnapshotSubsystem* Snapshots = UWorldSnapshotSubsystem::Get(World))
+		{
+			Snapshots->LoadSnapshot(Args.Num() > 0 ? Args[0] : TEXT("Quick"));
+		}
+	}));
+
+namespace
+{
+	/** Live actors of type T in World, by name */
+	template<typename T>
+	TMap<FName, T*> GatherActors(UWorld* World)
+	{
+		TMap<FName, T*> Actors;
+		for (TActorIterator<T> It(World); It; ++It)
+		{
+			Actors.Add(It->GetFName(), *It);
+		}
+		return Actors;
+	}
+
+	/** The actor Record names, taken out of Existing and placed where Record says; null if there isn't one */
+	template<typename T>
+	T* FindActor(const FActorSnapshot& Record, TMap<FName, T*>& Existing)
+	{
+		T* Actor{ nullptr };
+		if (Existing.RemoveAndCopyValue(Record.Name, Actor))
+		{
+			Actor->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+			Actor->SetActorLocationAndRotation(Record.Location, Record.Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+		}
+		return Actor;
+	}
+
+	/**
+	* A new actor of Record's class, placed where Record says
+	* @param BeforeFinishSpawning  Setup that has to happen before the actor's construction script
+	*/
+	template<typename T>
+	T* SpawnSnapshotActor(
+		UWorld* World,
+		const FWorldSnapshot& Snapshot,
+		const FActorSnapshot& Record,
+		TFunctionRef<void(T*)> BeforeFinishSpawning)
+	{
+		UClass* Class = Snapshot.ClassPaths.IsValidIndex(Record.ClassIndex) ?
+			FSoftClassPath(Snapshot.ClassPaths[Record.ClassIndex]).ResolveClass() :
+			nullptr;
+		if (Class == nullptr || !Class->IsChildOf(T::StaticClass())) return nullptr;
+
+		// Keep the saved name where it's free, so a later snapshot still finds this actor
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.Name = Record.Name;
+		SpawnParams.NameMode = FActorSpawnParameters::ESpawnActorNameMode::Requested;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		SpawnParams.bDeferConstruction = true;
+		const FTransform Transform{ Record.Rotation, Record.Location };
+		T* Actor = World->SpawnActor<T>(Class, Transform, SpawnParams);
+		if (Actor == nullptr) return nullptr;
+
+		BeforeFinishSpawning(Actor);
+		Actor->FinishSpawning(Transform);
+		INC_DWORD_STAT(STAT_SnapshotActorsSpawned);
+		return Actor;
+	}
+
+	/** Actors the snapshot has no record of were gone when it was taken */
+	template<typename T>
+	void DestroyActors(const TMap<FName, T*>& Actors)
+	{
+		for (const TPair<FName, T*>& Actor : Actors)
+		{
+			Actor.Value->Destroy();
+		}
+		INC_DWORD_STAT_BY(STAT_SnapshotActorsDestroyed, Actors.Num());
+	}
+}
+
+void UWorldSnapshotSubsystem::Deinitialize()
+{
+	// Don't leave a half written file behind
+	if (PendingSave.IsValid())
+	{
+		PendingSave.Wait();
+	}
+	if (ClassLoadHandle.IsValid())
+	{
+		ClassLoadHandle->CancelHandle();
+		ClassLoadHandle.Reset();
+	}
+
+	Super::Deinitialize();
+}
+
+UWorldSnapshotSubsystem* UWorldSnapshotSubsystem::Get(const UObject* WorldContextObject)
+{
+	UGameInstance* GameInstance = UGameplayStatics::GetGameInstance(WorldContextObject);
+	return GameInstance ? GameInstance->GetSubsystem<UWorldSnapshotSubsystem>() : nullptr;
+}
+
+FString UWorldSnapshotSubsystem::GetSnapshotPath(const FString& SlotName)
+{
+	return FPaths::ProjectSavedDir() / TEXT("Snapshots") / SlotName + TEXT(".snapshot");
+}
+
+bool UWorldSnapshotSubsystem::IsSaving() const
+{
+	return PendingSave.IsValid() && !PendingSave.IsReady();
+}
+
+void UWorldSnapshotSubsystem::SaveSnapshot(const FString& SlotName)
+{
+	UWorld* World = GetGameInstance()->GetWorld();
+	if (World == nullptr) return;
+	if (IsSaving() || bLoading)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Snapshot %s skipped: a snapshot is still being saved or loaded"), *SlotName);
+		return;
+	}
+
+	FWorldSnapshot Snapshot;
+	CaptureWorld(World, Snapshot);
+
+	// Written to a temporary file and moved over the slot, so a failed write keeps the previous snapshot
+	PendingSave = Async(EAsyncExecution::ThreadPool, [Snapshot = MoveTemp(Snapshot), SlotName]() mutable
+	{
+		const FString Path{ GetSnapshotPath(SlotName) };
+		const FString TempPath{ Path + TEXT(".tmp") };
+		TArray<uint8> Bytes;
+		const bool bSaved{
+			Snapshot.Write(Bytes) &&
+			FFileHelper::SaveArrayToFile(Bytes, *TempPath) &&
+			IFileManager::Get().Move(*Path, *TempPath) };
+		if (!bSaved)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Failed to save snapshot %s"), *Path);
+		}
+		return bSaved;
+	});
+}
+
+void UWorldSnapshotSubsystem::LoadSnapshot(const FString& SlotName)
+{
+	if (bLoading) return;
+	bLoading = true;
+
+	// The slot may be the one still being written
+	if (PendingSave.IsValid())
+	{
+		PendingSave.Wait();
+	}
+
+	TWeakObjectPtr<UWorldSnapshotSubsystem> WeakThis{ this };
+	Async(EAsyncExecution::ThreadPool, [WeakThis, Path = GetSnapshotPath(SlotName)]()
+	{
+		FWorldSnapshot Snapshot;
+		TArray<uint8> Bytes;
+		const bool bRead{ FFileHelper::LoadFileToArray(Bytes, *Path) && Snapshot.Read(Bytes) };
+		if (!bRead)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Failed to read snapshot %s"), *Path);
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, bRead, Snapshot = MoveTemp(Snapshot)]() mutable
+		{
+			if (UWorldSnapshotSubsystem* This = WeakThis.Get())
+			{
+				This->OnSnapshotRead(bRead, MoveTemp(Snapshot));
+			}
+		});
+	});
+}
+
+void UWorldSnapshotSubsystem::OnSnapshotRead(bool bRead, FWorldSnapshot&& Snapshot)
+{
+	const UWorld* World = GetGameInstance()->GetWorld();
+	if (!bRead || World == nullptr)
+	{
+		bLoading = false;
+		return;
+	}
+	if (Snapshot.MapName != UGameplayStatics::GetCurrentLevelName(World, true))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Snapshot is of %s, not the current level"), *Snapshot.MapName);
+		bLoading = false;
+		return;
+	}
+
+	// Classes of actors that have to be spawned may not be loaded yet; don't load them synchronously
+	LoadedSnapshot = MoveTemp(Snapshot);
+	TArray<FSoftObjectPath> ClassPaths;
+	for (const FString& ClassPath : LoadedSnapshot.ClassPaths)
+	{
+		ClassPaths.Add(FSoftObjectPath(ClassPath));
+	}
+	ClassLoadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+		ClassPaths,
+		FStreamableDelegate::CreateUObject(this, &UWorldSnapshotSubsystem::ApplyLoadedSnapshot));
+	if (!ClassLoadHandle.IsValid())
+	{
+		ApplyLoadedSnapshot();
+	}
+}
+
+void UWorldSnapshotSubsystem::ApplyLoadedSnapshot()
+{
+	if (!bLoading) return;
+
+	if (UWorld* World = GetGameInstance()->GetWorld())
+	{
+		ApplyWorld(World, LoadedSnapshot);
+	}
+	LoadedSnapshot = FWorldSnapshot();
+	ClassLoadHandle.Reset();
+	bLoading = false;
+}
+
+void UWorldSnapshotSubsystem::CaptureActor(FWorldSnapshot& Snapshot, const AActor* Actor, FActorSnapshot& Record)
+{
+	Record.ClassIndex = Snapshot.AddClass(Actor->GetClass());
+	Record.Name = Actor->GetFName();
+	Record.Location = Actor->GetActorLocation();
+	Record.Rotation = Actor->GetActorRotation();
+}
+
+AItem* UWorldSnapshotSubsystem::SpawnItem(UWorld* World, const FWorldSnapshot& Snapshot, const FItemSnapshot& Record)
+{
+	AItem* Item = SpawnSnapshotActor<AItem>(World, Snapshot, Record.Actor, [&Record](AItem* NewItem)
+	{
+		NewItem->SetItemRarity(static_cast<EItemRarity>(Record.ItemRarity));
+	});
+	if (Item)
+	{
+		Item->RestoreSnapshot(Record);
+	}
+	return Item;
+}
+
+AEnemy* UWorldSnapshotSubsystem::SpawnEnemy(UWorld* World, const FWorldSnapshot& Snapshot, const FEnemySnapshot& Record, AActor* Target)
+{
+	AEnemy* Enemy = SpawnSnapshotActor<AEnemy>(World, Snapshot, Record.Actor, [](AEnemy* NewEnemy)
+	{
+		// Placed enemies may only possess when placed; a respawned one needs its controller too
+		NewEnemy->AutoPossessAI = EAutoPossessAI::PlacedInWorldOrSpawned;
+	});
+	if (Enemy)
+	{
+		Enemy->RestoreSnapshot(Record, Target);
+	}
+	return Enemy;
+}
+
+AExplosive* UWorldSnapshotSubsystem::SpawnExplosive(UWorld* World, const FWorldSnapshot& Snapshot, const FActorSnapshot& Record)
+{
+	return SpawnSnapshotActor<AExplosive>(World, Snapshot, Record, [](AExplosive*) {});
+}
+
+void UWorldSnapshotSubsystem::CaptureWorld(UWorld* World, FWorldSnapshot& Snapshot)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SnapshotCapture);
+
+	Snapshot.MapName = UGameplayStatics::GetCurrentLevelName(World, true);
+
+	const AShooterCharacter* Player = Cast<AShooterCharacter>(UGameplayStatics::GetPlayerCharacter(World, 0));
+	Snapshot.bHasPlayer = Player != nullptr;
+	if (Player)
+	{
+		Player->CaptureSnapshot(Snapshot.Player);
+	}
+
+	for (TActorIterator<AItem> It(World); It; ++It)
+	{
+		FItemSnapshot& Record = Snapshot.Items.AddDefaulted_GetRef();
+		CaptureActor(Snapshot, *It, Record.Actor);
+		It->CaptureSnapshot(Record);
+	}
+
+	for (TActorIterator<AEnemy> It(World); It; ++It)
+	{
+		// Dying enemies are as good as dead
+		if (It->GetDying()) continue;
+
+		FEnemySnapshot& Record = Snapshot.Enemies.AddDefaulted_GetRef();
+		CaptureActor(Snapshot, *It, Record.Actor);
+		It->CaptureSnapshot(Record);
+	}
+
+	for (TActorIterator<AExplosive> It(World); It; ++It)
+	{
+		CaptureActor(Snapshot, *It, Snapshot.Explosives.AddDefaulted_GetRef());
+	}
+
+	// Actors in far cells are records, not actors, right now
+	if (const UActorStreamingSubsystem* Streaming = UActorStreamingSubsystem::Get(World))
+	{
+		Streaming->CaptureStreamedOut(Snapshot);
+	}
+}
+
+void UWorldSnapshotSubsystem::ApplyWorld(UWorld* World, const FWorldSnapshot& Snapshot)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SnapshotApply);
+
+	// Restored actors by saved name, for the references between records
+	TMap<FName, AActor*> Restored;
+	AShooterCharacter* Player = Cast<AShooterCharacter>(UGameplayStatics::GetPlayerCharacter(World, 0));
+	if (Player)
+	{
+		Restored.Add(Player->GetFName(), Player);
+	}
+
+	// The snapshot lists streamed out actors too, so records from before it are stale.
+	// Actors it puts far from the player are handed back as records rather than spawned.
+	UActorStreamingSubsystem* Streaming = UActorStreamingSubsystem::Get(World);
+	if (Streaming)
+	{
+		Streaming->DiscardStreamedOut();
+	}
+	const FVector ViewerLocation{ Snapshot.bHasPlayer ?
+		Snapshot.Player.Location :
+		(Player ? Player->GetActorLocation() : FVector::ZeroVector) };
+
+	TMap<FName, AItem*> Items{ GatherActors<AItem>(World) };
+	for (const FItemSnapshot& Record : Snapshot.Items)
+	{
+		AItem* Item = FindActor(Record.Actor, Items);
+		if (Item)
+		{
+			Item->RestoreSnapshot(Record);
+		}
+		else if (Streaming && Streaming->AdoptItem(Snapshot, Record, ViewerLocation))
+		{
+			continue;
+		}
+		else
+		{
+			Item = SpawnItem(World, Snapshot, Record);
+		}
+		if (Item)
+		{
+			Restored.Add(Record.Actor.Name, Item);
+		}
+	}
+	DestroyActors(Items);
+
+	TMap<FName, AEnemy*> Enemies{ GatherActors<AEnemy>(World) };
+	for (auto It = Enemies.CreateIterator(); It; ++It)
+	{
+		// A dying enemy can't be brought back: its death montage and DeathTimer carry on.
+		// It goes now, and a record for it respawns it alive
+		if (It.Value()->GetDying())
+		{
+			It.Value()->Destroy();
+			INC_DWORD_STAT(STAT_SnapshotActorsDestroyed);
+			It.RemoveCurrent();
+		}
+	}
+	for (const FEnemySnapshot& Record : Snapshot.Enemies)
+	{
+		AEnemy* Enemy = FindActor(Record.Actor, Enemies);
+		if (Enemy)
+		{
+			Enemy->RestoreSnapshot(Record, Restored.FindRef(Record.Target));
+		}
+		else if (Streaming == nullptr || !Streaming->AdoptEnemy(Snapshot, Record, ViewerLocation))
+		{
+			SpawnEnemy(World, Snapshot, Record, Restored.FindRef(Record.Target));
+		}
+	}
+	DestroyActors(Enemies);
+
+	TMap<FName, AExplosive*> Explosives{ GatherActors<AExplosive>(World) };
+	for (const FActorSnapshot& Record : Snapshot.Explosives)
+	{
+		if (FindActor(Record, Explosives) == nullptr &&
+			(Streaming == nullptr || !Streaming->AdoptExplosive(Snapshot, Record, ViewerLocation)))
+		{
+			SpawnExplosive(World, Snapshot, Record);
+		}
+	}
+	DestroyActors(Explosives);
+
+	// Last, so the inventory refers to items that are already restored
+	if (Player && Snapshot.bHasPlayer)
+	{
+		TArray<AItem*> InventoryItems;
+		for (const FName& ItemName : Snapshot.Player.InventoryItems)
+		{
+			InventoryItems.Add(Cast<AItem>(Restored.FindRef(ItemName)));
+		}
+		Player->RestoreSnapshot(Snapshot.Player, InventoryItems);
+	}
+}
+
+void UWorldSnapshotSubsystem::Tick(float DeltaTime)
+{
+	const float AutosaveInterval{ CVarAutosaveInterval.GetValueOnGameThread() };
+	if (AutosaveInterval <= 0.f) return;
+
+	TimeSinceAutosave += DeltaTime;
+	if (TimeSinceAutosave >= AutosaveInterval && !IsSaving() && !bLoading)
+	{
+		TimeSinceAutosave = 0.f;
+		SaveSnapshot(TEXT("Autosave"));
+	}
+}
+
+bool UWorldSnapshotSubsystem::IsTickable() const
+{
+	if (IsTemplate()) return false;
+
+	const UWorld* World = GetTickableGameObjectWorld();
+	return World && World->IsGameWorld() && World->HasBegunPlay();
+}
+
+TStatId UWorldSnapshotSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UWorldSnapshotSubsystem, STATGROUP_Tickables);
+}
+
+UWorld* UWorldSnapshotSubsystem::GetTickableGameObjectWorld() const
+{
+	const UGameInstance* GameInstance = IsTemplate() ? nullptr : GetGameInstance();
+	return GameInstance ? GameInstance->GetWorld() : nullptr;
+}
@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Tickable.h"
+#include "Async/Future.h"
+#include "Engine/StreamableManager.h"
+#include "WorldSnapshot.h"
+#include "WorldSnapshotSubsystem.generated.h"
+
+/**
+ * Saves and restores the player, items, enemies and explosives of the current level
+ * as binary snapshots in Saved/Snapshots. Only the capture runs on the game thread;
+ * serializing, compression and file IO happen on a worker, so autosaves don't hitch.
+ * Loading reuses the actors already in the level, matching them by name, and only
+ * spawns or destroys the difference, so there is no level reload.
+ */
+UCLASS()
+class SHOOTER_API UWorldSnapshotSubsystem : public UGameInstanceSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	static UWorldSnapshotSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Capture now and write SlotName in the background; skipped while another save is writing */
+	void SaveSnapshot(const FString& SlotName);
+
+	/** Read SlotName in the background and apply it to the current level once read */
+	void LoadSnapshot(const FString& SlotName);
+
+	bool IsSaving() const;
+	FORCEINLINE bool IsLoading() const { return bLoading; }
+
+	static FString GetSnapshotPath(const FString& SlotName);
+
+	/** Record the state of everything in World that snapshots cover */
+	static void CaptureWorld(UWorld* World, FWorldSnapshot& Snapshot);
+
+	/** Make World match Snapshot; its classes must already be loaded */
+	static void ApplyWorld(UWorld* World, const FWorldSnapshot& Snapshot);
+
+	/** Fill in the part of Record every actor shares */
+	static void CaptureActor(FWorldSnapshot& Snapshot, const AActor* Actor, FActorSnapshot& Record);
+
+	/** Spawn and restore the actor a record stands for; null if its class isn't loaded */
+	static class AItem* SpawnItem(UWorld* World, const FWorldSnapshot& Snapshot, const FItemSnapshot& Record);
+	static class AEnemy* SpawnEnemy(UWorld* World, const FWorldSnapshot& Snapshot, const FEnemySnapshot& Record, AActor* Target);
+	static class AExplosive* SpawnExplosive(UWorld* World, const FWorldSnapshot& Snapshot, const FActorSnapshot& Record);
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+
+private:
+	/** Back on the game thread with the file read; load the snapshot's classes, then apply */
+	void OnSnapshotRead(bool bRead, FWorldSnapshot&& Snapshot);
+
+	void ApplyLoadedSnapshot();
+
+	/** Result of the save being written, if any */
+	TFuture<bool> PendingSave;
+
+	bool bLoading{ false };
+
+	/** Read snapshot waiting on its classes */
+	FWorldSnapshot LoadedSnapshot;
+	TSharedPtr<FStreamableHandle> ClassLoadHandle;
+
+	float TimeSinceAutosave{ 0.f };
+};
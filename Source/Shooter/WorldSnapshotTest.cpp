@@ -0,0 +1,153 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+#include "GameFramework/Actor.h"
+#include "WorldSnapshot.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	FWorldSnapshot MakeTestSnapshot()
+	{
+		FWorldSnapshot Snapshot;
+		Snapshot.MapName = TEXT("/Game/Maps/TestMap");
+
+		FItemSnapshot Item;
+		Item.Actor.ClassIndex = Snapshot.AddClass(AActor::StaticClass());
+		Item.Actor.Name = TEXT("Weapon_3");
+		Item.Actor.Location = FVector(100.f, -200.f, 50.f);
+		Item.Actor.Rotation = FRotator(0.f, 90.f, 0.f);
+		Item.ItemState = 2;
+		Item.ItemRarity = 4;
+		Item.ItemCount = 1;
+		Item.WeaponAmmo = 17;
+		Snapshot.Items.Add(Item);
+
+		FEnemySnapshot Enemy;
+		Enemy.Actor.ClassIndex = Snapshot.AddClass(AActor::StaticClass());
+		Enemy.Actor.Name = TEXT("Enemy_1");
+		Enemy.Actor.Location = FVector(-500.f, 0.f, 90.f);
+		Enemy.Health = 42.5f;
+		Enemy.Target = TEXT("ShooterCharacter_0");
+		Enemy.PatrolPoint = FVector(10.f, 20.f, 0.f);
+		Enemy.PatrolPoint2 = FVector(-10.f, -20.f, 0.f);
+		Snapshot.Enemies.Add(Enemy);
+
+		FActorSnapshot Explosive;
+		Explosive.ClassIndex = Snapshot.AddClass(UObject::StaticClass());
+		Explosive.Name = TEXT("Barrel_7");
+		Snapshot.Explosives.Add(Explosive);
+
+		Snapshot.bHasPlayer = true;
+		Snapshot.Player.Location = FVector(1.f, 2.f, 3.f);
+		Snapshot.Player.Rotation = FRotator(0.f, 45.f, 0.f);
+		Snapshot.Player.ControlRotation = FRotator(-10.f, 45.f, 0.f);
+		Snapshot.Player.Health = 75.f;
+		Snapshot.Player.CarriedAmmo.Add(TEXT("9mm"), 85);
+		Snapshot.Player.CarriedAmmo.Add(TEXT("AR"), 120);
+		Snapshot.Player.InventoryItems = { TEXT("Weapon_0"), NAME_None, TEXT("Weapon_3") };
+		Snapshot.Player.StackCounts = { 1, 0, 1 };
+		Snapshot.Player.EquippedSlot = 2;
+		return Snapshot;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWorldSnapshotRoundTripTest, "Shooter.WorldSnapshot.WriteReadRoundTrip",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FWorldSnapshotRoundTripTest::RunTest(const FString& Parameters)
+{
+	FWorldSnapshot Written{ MakeTestSnapshot() };
+	TArray<uint8> Bytes;
+	if (!TestTrue(TEXT("Write succeeds"), Written.Write(Bytes))) return false;
+
+	FWorldSnapshot Read;
+	if (!TestTrue(TEXT("Read succeeds"), Read.Read(Bytes))) return false;
+
+	TestEqual(TEXT("MapName"), Read.MapName, Written.MapName);
+	TestEqual(TEXT("Classes shared between records"), Read.ClassPaths.Num(), 2);
+	TestEqual(TEXT("ClassPaths"), Read.ClassPaths, Written.ClassPaths);
+
+	if (TestEqual(TEXT("Item count"), Read.Items.Num(), 1))
+	{
+		const FItemSnapshot& Item = Read.Items[0];
+		TestEqual(TEXT("Item class"), Item.Actor.ClassIndex, Written.Items[0].Actor.ClassIndex);
+		TestEqual(TEXT("Item name"), Item.Actor.Name, Written.Items[0].Actor.Name);
+		TestEqual(TEXT("Item location"), Item.Actor.Location, Written.Items[0].Actor.Location);
+		TestEqual(TEXT("Item rotation"), Item.Actor.Rotation, Written.Items[0].Actor.Rotation);
+		TestEqual(TEXT("Item state"), Item.ItemState, Written.Items[0].ItemState);
+		TestEqual(TEXT("Item rarity"), Item.ItemRarity, Written.Items[0].ItemRarity);
+		TestEqual(TEXT("Item count"), Item.ItemCount, Written.Items[0].ItemCount);
+		TestEqual(TEXT("Weapon ammo"), Item.WeaponAmmo, Written.Items[0].WeaponAmmo);
+	}
+
+	if (TestEqual(TEXT("Enemy count"), Read.Enemies.Num(), 1))
+	{
+		const FEnemySnapshot& Enemy = Read.Enemies[0];
+		TestEqual(TEXT("Enemy name"), Enemy.Actor.Name, Written.Enemies[0].Actor.Name);
+		TestEqual(TEXT("Enemy location"), Enemy.Actor.Location, Written.Enemies[0].Actor.Location);
+		TestEqual(TEXT("Enemy health"), Enemy.Health, Written.Enemies[0].Health);
+		TestEqual(TEXT("Enemy target"), Enemy.Target, Written.Enemies[0].Target);
+		TestEqual(TEXT("Patrol point"), Enemy.PatrolPoint, Written.Enemies[0].PatrolPoint);
+		TestEqual(TEXT("Patrol point 2"), Enemy.PatrolPoint2, Written.Enemies[0].PatrolPoint2);
+	}
+
+	if (TestEqual(TEXT("Explosive count"), Read.Explosives.Num(), 1))
+	{
+		TestEqual(TEXT("Explosive class"), Read.Explosives[0].ClassIndex, Written.Explosives[0].ClassIndex);
+		TestEqual(TEXT("Explosive name"), Read.Explosives[0].Name, Written.Explosives[0].Name);
+	}
+
+	TestTrue(TEXT("Has player"), Read.bHasPlayer);
+	const FPlayerSnapshot& Player = Read.Player;
+	TestEqual(TEXT("Player location"), Player.Location, Written.Player.Location);
+	TestEqual(TEXT("Player rotation"), Player.Rotation, Written.Player.Rotation);
+	TestEqual(TEXT("Control rotation"), Player.ControlRotation, Written.Player.ControlRotation);
+	TestEqual(TEXT("Player health"), Player.Health, Written.Player.Health);
+	TestTrue(TEXT("Carried ammo"), Player.CarriedAmmo.OrderIndependentCompareEqual(Written.Player.CarriedAmmo));
+	TestEqual(TEXT("Inventory items"), Player.InventoryItems, Written.Player.InventoryItems);
+	TestEqual(TEXT("Stack counts"), Player.StackCounts, Written.Player.StackCounts);
+	TestEqual(TEXT("Equipped slot"), Player.EquippedSlot, Written.Player.EquippedSlot);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWorldSnapshotRejectTest, "Shooter.WorldSnapshot.ReadRejectsBadData",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FWorldSnapshotRejectTest::RunTest(const FString& Parameters)
+{
+	FWorldSnapshot Written{ MakeTestSnapshot() };
+	TArray<uint8> Bytes;
+	if (!TestTrue(TEXT("Write succeeds"), Written.Write(Bytes))) return false;
+
+	FWorldSnapshot Read;
+	TestFalse(TEXT("Empty data"), Read.Read(TArray<uint8>()));
+
+	TArray<uint8> BadMagic{ Bytes };
+	BadMagic[0] ^= 0xFF;
+	TestFalse(TEXT("Wrong magic"), Read.Read(BadMagic));
+
+	// Header is magic, version, uncompressed size
+	TArray<uint8> NewerVersion{ Bytes };
+	const int32 Newer{ FWorldSnapshotVersion::LatestVersion + 1 };
+	FMemory::Memcpy(NewerVersion.GetData() + sizeof(uint32), &Newer, sizeof(Newer));
+	TestFalse(TEXT("Newer version"), Read.Read(NewerVersion));
+
+	TArray<uint8> Oversized{ Bytes };
+	const int32 HugeSize{ MAX_int32 };
+	FMemory::Memcpy(Oversized.GetData() + sizeof(uint32) + sizeof(int32), &HugeSize, sizeof(HugeSize));
+	TestFalse(TEXT("Uncompressed size too large"), Read.Read(Oversized));
+
+	TArray<uint8> Truncated{ Bytes };
+	Truncated.SetNum(Bytes.Num() / 2);
+	// zlib reports the bad stream through LogCompression before Read turns it down
+	AddExpectedError(TEXT("Failed to uncompress memory"), EAutomationExpectedErrorFlags::Contains, 1);
+	TestFalse(TEXT("Truncated payload"), Read.Read(Truncated));
+
+	return true;
+}
+
+#endif